@@ -5,6 +5,10 @@
 
 UART_TX = 0x10000000
 
+# Assembled with --defsym CONV0_LIB=1 only the kernel is kept (no _start, test
+# buffers or stack), so it links into a C program: ResNet-8/conv0_impls.h
+.ifndef CONV0_LIB
+    .type _start, @function
 _start:
     la   sp, _stack_top
 
@@ -35,12 +39,17 @@ print_hex:
     li   s1, '\n'
     sb   s1, 0(s3)
     j    .
+    .size _start, .-_start
 
 .section .rodata
 HEX_CHARS:
     .ascii "0123456789ABCDEF"
+.endif
+
+.section .text
 
 .globl conv0_v1
+    .type conv0_v1, @function
 conv0_v1:
     li   s0, 0                  # out_ch
 out_ch:
@@ -148,3 +157,4 @@ skip_mac:
     blt  s0, t0, out_ch
 
     ret
+    .size conv0_v1, .-conv0_v1
@@ -5,7 +5,11 @@
 .global conv0_v2
 UART_TX = 0x10000000
 
+# Assembled with --defsym CONV0_LIB=1 only the kernel is kept (no _start, test
+# buffers or stack), so it links into a C program: ResNet-8/conv0_impls.h
+.ifndef CONV0_LIB
 # _start: create halo 34x34x3,cycle count, calls conv0_v2, HEX print
+    .type _start, @function
 _start:
     la   sp, _stack_top
 
@@ -87,7 +91,10 @@ print_hex:
     li   s1, '\n'
     sb   s1, 0(s3)
     j    .
+    .size _start, .-_start
+.endif
 
+    .type conv0_v2, @function
 conv0_v2:
     li   s0, 0                  # oc = 0..31
 oc_loop:
@@ -214,7 +221,9 @@ ow_loop:
     li   t0, 32
     blt  s0, t0, oc_loop
     ret
+    .size conv0_v2, .-conv0_v2
 
+.ifndef CONV0_LIB
 .section .bss
 .balign 4
 input_halo: .space 34*34*3       
@@ -227,3 +236,4 @@ HEX_CHARS: .ascii "0123456789ABCDEF"
 .balign 16
 _space_stack: .space 0x1000
 _stack_top:
+.endif
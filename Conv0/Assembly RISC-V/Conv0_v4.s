@@ -0,0 +1,245 @@
+.option norvc
+.option nopic
+.section .text
+.global _start
+.global conv0_v4
+UART_TX = 0x10000000
+
+# Assembled with --defsym CONV0_LIB=1 only the kernel is kept (no _start, test
+# buffers or stack), so it links into a C program: ResNet-8/conv0_impls.h
+.ifndef CONV0_LIB
+# _start: create RGBX halo 34x34x4 and RGBX weights 32x3x3x4, cycle count, calls conv0_v4, HEX print
+#   halo_rgbx[ih][iw] = {in[0][ih][iw], in[1][ih][iw], in[2][ih][iw], 0}   (one word per pixel)
+#   w_rgbx[oc][kh][kw] = {W[oc][0][kh][kw], W[oc][1][kh][kw], W[oc][2][kh][kw], 0}
+    .type _start, @function
+_start:
+    la   sp, _stack_top
+
+    csrr s11, mcycle            # s11 is never touched by conv0_v4
+
+    # Halo + X bytes Reset (halo_rgbx and w_rgbx are contiguous: 578 + 144 dwords)
+    la   t5, halo_rgbx
+    li   t4, 722
+zero_loop:
+    sd   x0, 0(t5)
+    addi t5, t5, 8
+    addi t4, t4, -1
+    bnez t4, zero_loop
+
+    la   s0, input
+    la   s1, halo_rgbx
+    li   s2, 0                  # in_ch = 0..2
+copy_ic:
+    # halo base = s1 + (34 + 1)*4 + ic   (byte ic of pixel [1][1])
+    addi t4, s1, 140
+    add  t4, t4, s2
+    li   s3, 32                 # rows
+copy_row:
+    li   s4, 32                 # cols
+copy_col:
+    lbu  t1, 0(s0)              # input is read once, in order
+    sb   t1, 0(t4)
+    addi s0, s0, 1
+    addi t4, t4, 4
+    addi s4, s4, -1
+    bnez s4, copy_col
+
+    addi t4, t4, 8              # skip right halo of this row + left halo of next
+    addi s3, s3, -1
+    bnez s3, copy_row
+
+    addi s2, s2, 1
+    li   t0, 3
+    blt  s2, t0, copy_ic
+
+    # Weight interleave: W[oc][ic][kh][kw] -> byte ic of w_rgbx[oc][kh][kw]
+    la   s0, weights
+    la   s1, w_rgbx
+    li   s2, 32                 # oc
+pack_oc:
+    mv   t4, s1
+    li   s3, 3                  # ic
+pack_ic:
+    mv   t5, t4
+    li   s4, 9                  # kh*3 + kw
+pack_tap:
+    lbu  t1, 0(s0)
+    sb   t1, 0(t5)
+    addi s0, s0, 1
+    addi t5, t5, 4
+    addi s4, s4, -1
+    bnez s4, pack_tap
+
+    addi t4, t4, 1
+    addi s3, s3, -1
+    bnez s3, pack_ic
+
+    addi s1, s1, 36
+    addi s2, s2, -1
+    bnez s2, pack_oc
+
+    la   a0, halo_rgbx          # padded RGBX input
+    la   a1, output             # output[32][32][32]
+    la   a2, w_rgbx             # weights[32][3][3] RGBX
+    la   a3, bias               # bias [32]
+    call conv0_v4
+
+    # mcycle end & print
+    csrr s10, mcycle
+    sub  s9, s10, s11
+
+    li   s0, 16
+print_hex:
+    srli s1, s9, 60
+    andi s1, s1, 0xF
+    la   s2, HEX_CHARS
+    add  s1, s1, s2
+    lb   s1, 0(s1)
+    li   s3, UART_TX
+    sb   s1, 0(s3)
+    slli s9, s9, 4
+    addi s0, s0, -1
+    bnez s0, print_hex
+
+    li   s1, '\n'
+    sb   s1, 0(s3)
+    j    .
+    .size _start, .-_start
+.endif
+
+
+# Sign-extend the 3 channel bytes of the RGBX pixel at bit 'pos' (0 or 32) of src
+.macro UNPACK3 src, pos, r0, r1, r2
+    slli \r0, \src, 56-\pos
+    srai \r0, \r0, 56
+    slli \r1, \src, 48-\pos
+    srai \r1, \r1, 56
+    slli \r2, \src, 40-\pos
+    srai \r2, \r2, 56
+.endm
+
+# acc += x(a4,a7,s10) . w(wa,wb,wc)   (3 input channels of one tap)
+.macro MAC3 acc, wa, wb, wc
+    mul  t6, a4, \wa
+    add  \acc, \acc, t6
+    mul  t6, a7, \wb
+    add  \acc, \acc, t6
+    mul  t6, s10, \wc
+    add  \acc, \acc, t6
+.endm
+
+# One kernel row (3 taps x 3 channels) for a 1 oc x 4 ow tile.
+# 3 lw fetch the 9 weights of the row, 3 ld fetch the 6 pixels under it
+# (two RGBX pixels per ld): 6 loads for 36 MACs (conv0_v2: 72).
+#   a5 = &halo_rgbx[oh][ow]   a2 = &w_rgbx[oc][0][0]
+#   weights kw0: t0..t2  kw1: t3..t5  kw2: s7..s9    acc: s3..s6
+.macro CONV_ROW_RGBX roff, woff
+    lw   t6, \woff+0(a2)
+    UNPACK3 t6, 0, t0, t1, t2
+    lw   t6, \woff+4(a2)
+    UNPACK3 t6, 0, t3, t4, t5
+    lw   t6, \woff+8(a2)
+    UNPACK3 t6, 0, s7, s8, s9
+
+    ld   a0, \roff+0(a5)        # x0 | x1
+    UNPACK3 a0, 0, a4, a7, s10  # x0: (ow0,kw0)
+    MAC3 s3, t0, t1, t2
+    UNPACK3 a0, 32, a4, a7, s10 # x1: (ow0,kw1) (ow1,kw0)
+    MAC3 s3, t3, t4, t5
+    MAC3 s4, t0, t1, t2
+
+    ld   a0, \roff+8(a5)        # x2 | x3
+    UNPACK3 a0, 0, a4, a7, s10  # x2: (ow0,kw2) (ow1,kw1) (ow2,kw0)
+    MAC3 s3, s7, s8, s9
+    MAC3 s4, t3, t4, t5
+    MAC3 s5, t0, t1, t2
+    UNPACK3 a0, 32, a4, a7, s10 # x3: (ow1,kw2) (ow2,kw1) (ow3,kw0)
+    MAC3 s4, s7, s8, s9
+    MAC3 s5, t3, t4, t5
+    MAC3 s6, t0, t1, t2
+
+    ld   a0, \roff+16(a5)       # x4 | x5
+    UNPACK3 a0, 0, a4, a7, s10  # x4: (ow2,kw2) (ow3,kw1)
+    MAC3 s5, s7, s8, s9
+    MAC3 s6, t3, t4, t5
+    UNPACK3 a0, 32, a4, a7, s10 # x5: (ow3,kw2)
+    MAC3 s6, s7, s8, s9
+.endm
+
+# Quantization (>>8), ReLU and saturation, then store at off(a1)
+.macro QRELU_STORE acc, off
+    srai \acc, \acc, 8
+    bge  \acc, x0, 1f
+    li   \acc, 0
+1:
+    li   t0, 127
+    ble  \acc, t0, 2f
+    li   \acc, 127
+2:
+    sb   \acc, \off(a1)
+.endm
+
+# conv0_v4: conv0 on RGBX-interleaved input and weights, 1 oc x 4 ow per tile.
+# Every tap reads all 3 channels with one word; pixel pairs come in with one ld
+# (ow is a multiple of 4 and the halo row is 136 bytes, so ld stays 8-aligned).
+#   a0 = halo_rgbx[34][34] (clobbered, used as ld destination)
+#   a1 = output[32][32][32]   a2 = w_rgbx[32][3][3]   a3 = bias[32]
+    .type conv0_v4, @function
+conv0_v4:
+    mv   a6, a0                 # a6 = &halo_rgbx[oh][0]  (row pointer)
+    li   s0, 32                 # oc
+oc_loop:
+    li   s1, 32                 # oh rows
+oh_loop:
+    mv   a5, a6                 # a5 = &halo_rgbx[oh][ow]
+    li   s2, 8                  # ow tiles (4 columns each)
+ow_loop:
+    # acc = bias[oc]
+    lw   s3, 0(a3)
+    mv   s4, s3
+    mv   s5, s3
+    mv   s6, s3
+
+    CONV_ROW_RGBX 0, 0
+    CONV_ROW_RGBX 136, 12
+    CONV_ROW_RGBX 272, 24
+
+    QRELU_STORE s3, 0           # output[oc][oh][ow..ow+3]
+    QRELU_STORE s4, 1
+    QRELU_STORE s5, 2
+    QRELU_STORE s6, 3
+
+    #next ow/oh/oc
+    addi a1, a1, 4
+    addi a5, a5, 16
+    addi s2, s2, -1
+    bnez s2, ow_loop
+
+    addi a6, a6, 136
+    addi s1, s1, -1
+    bnez s1, oh_loop
+
+    li   t0, 32*136             # back to halo row 0
+    sub  a6, a6, t0
+    addi a2, a2, 36             # 9 RGBX weight words
+    addi a3, a3, 4
+    addi s0, s0, -1
+    bnez s0, oc_loop
+    ret
+    .size conv0_v4, .-conv0_v4
+
+.ifndef CONV0_LIB
+.section .bss
+.balign 8
+halo_rgbx: .space 34*34*4
+w_rgbx: .space 32*3*3*4
+# output e input/weights/bias are expected in data.s
+
+.section .rodata
+HEX_CHARS: .ascii "0123456789ABCDEF"
+
+.section .stack
+.balign 16
+_space_stack: .space 0x1000
+_stack_top:
+.endif
@@ -0,0 +1,177 @@
+#include <stdint.h>
+
+#define IN_H 32
+#define IN_W 32
+#define IN_C 3
+#define OUT_C 32
+#define KERNEL_SIZE 3
+#define STRIDE 1
+#define PADDING 1
+#define OUT_H 32
+#define OUT_W 32
+#define HALO_H (IN_H + 2 * PADDING)
+#define HALO_W (IN_W + 2 * PADDING)
+#define UART_TX 0x10000000UL
+
+// UART print functions
+static inline void uart_putc(char c) { *(volatile uint8_t *)UART_TX = (uint8_t)c; }
+static void uart_puts(const char *s)
+{
+    while (*s)
+    {
+        uart_putc(*s++);
+    }
+}
+static void uart_puthex64(uint64_t x)
+{
+    static const char HEX[] = "0123456789ABCDEF";
+    for (int i = 15; i >= 0; i--)
+    {
+        uart_putc(HEX[(x >> (i * 4)) & 0xF]);
+    }
+}
+static inline uint64_t rdcycle(void)
+{
+    uint64_t v;
+    __asm__ volatile("csrr %0, mcycle" : "=r"(v));
+    return v;
+}
+
+int8_t conv0_w[OUT_C][IN_C][KERNEL_SIZE][KERNEL_SIZE];
+int32_t conv0_b[OUT_C];
+
+// RGBX layout: one 32-bit word per pixel/tap, byte c = channel c, byte 3 = 0
+static uint32_t in_rgbx[HALO_H][HALO_W];
+static uint32_t w_rgbx[OUT_C][KERNEL_SIZE][KERNEL_SIZE];
+
+static inline int8_t relu(int32_t x)
+{
+    if (x < 0)
+    {
+        x = 0;
+    }
+    else if (x > 127)
+    {
+        x = 127;
+    }
+    return (int8_t)x;
+}
+
+// Interleave the planar input into the zero-padded RGBX halo (only the
+// one-pixel border ring is cleared, the interior is overwritten)
+static void pack_input_rgbx(const int8_t input[IN_C][IN_H][IN_W])
+{
+    for (int i = 0; i < HALO_W; i++)
+    {
+        in_rgbx[0][i] = 0;
+        in_rgbx[HALO_H - 1][i] = 0;
+    }
+    for (int i = 1; i < HALO_H - 1; i++)
+    {
+        in_rgbx[i][0] = 0;
+        in_rgbx[i][HALO_W - 1] = 0;
+    }
+    for (int ih = 0; ih < IN_H; ih++)
+    {
+        for (int iw = 0; iw < IN_W; iw++)
+        {
+            in_rgbx[ih + PADDING][iw + PADDING] = (uint32_t)(uint8_t)input[0][ih][iw] |
+                                                  (uint32_t)(uint8_t)input[1][ih][iw] << 8 |
+                                                  (uint32_t)(uint8_t)input[2][ih][iw] << 16;
+        }
+    }
+}
+
+// One-time weight interleave, W[oc][ic][kh][kw] -> byte ic of w_rgbx[oc][kh][kw]
+static void pack_weights_rgbx(void)
+{
+    for (int oc = 0; oc < OUT_C; oc++)
+    {
+        for (int kh = 0; kh < KERNEL_SIZE; kh++)
+        {
+            for (int kw = 0; kw < KERNEL_SIZE; kw++)
+            {
+                w_rgbx[oc][kh][kw] = (uint32_t)(uint8_t)conv0_w[oc][0][kh][kw] |
+                                     (uint32_t)(uint8_t)conv0_w[oc][1][kh][kw] << 8 |
+                                     (uint32_t)(uint8_t)conv0_w[oc][2][kh][kw] << 16;
+            }
+        }
+    }
+}
+
+// 3-channel dot product of one pixel word with one weight word
+static inline int32_t dot3_rgbx(uint32_t px, uint32_t wx)
+{
+    return (int32_t)(int8_t)px * (int8_t)wx +
+           (int32_t)(int8_t)(px >> 8) * (int8_t)(wx >> 8) +
+           (int32_t)(int8_t)(px >> 16) * (int8_t)(wx >> 16);
+}
+
+// conv0 on the RGBX halo: one lw per tap instead of three lb, and no border test
+void conv0_rgbx(int8_t output[OUT_C][OUT_H][OUT_W])
+{
+    int32_t acc;
+    for (int oc = 0; oc < OUT_C; oc++)
+    {
+        for (int oh = 0; oh < OUT_H; oh++)
+        {
+            for (int ow = 0; ow < OUT_W; ow++)
+            {
+                acc = conv0_b[oc];
+                for (int kh = 0; kh < KERNEL_SIZE; kh++)
+                {
+                    for (int kw = 0; kw < KERNEL_SIZE; kw++)
+                    {
+                        acc += dot3_rgbx(in_rgbx[oh + kh][ow + kw], w_rgbx[oc][kh][kw]);
+                    }
+                }
+                acc >>= 8;
+                output[oc][oh][ow] = relu(acc);
+            }
+        }
+    }
+}
+
+int main() // testing main
+{
+    static int8_t input[IN_C][IN_H][IN_W];
+    static int8_t output[OUT_C][IN_H][IN_W];
+
+    for (int h = 0; h < IN_H; h++)
+        for (int w = 0; w < IN_W; w++)
+        {
+            input[0][h][w] = 1;
+            input[1][h][w] = 2;
+            input[2][h][w] = 3;
+        }
+
+    for (int oc = 0; oc < OUT_C; oc++)
+    {
+        conv0_b[oc] = 0;
+        for (int ic = 0; ic < IN_C; ic++)
+        {
+            for (int kh = 0; kh < KERNEL_SIZE; kh++)
+            {
+                for (int kw = 0; kw < KERNEL_SIZE; kw++)
+                {
+                    conv0_w[oc][ic][kh][kw] = 1;
+                }
+            }
+        }
+    }
+    pack_weights_rgbx(); // one-time, outside the measured region
+
+    uint64_t c0 = rdcycle();
+    pack_input_rgbx(input);
+    conv0_rgbx(output);
+    uint64_t c1 = rdcycle();
+
+    uart_puts("conv0 rgbx cycles: 0x"); // cycles print
+    uart_puthex64(c1 - c0);
+    uart_puts("\n");
+
+    for (;;) // intentional infinite loop to prevent program termination
+    {
+    }
+    return 0;
+}
@@ -0,0 +1,145 @@
+#include <stdint.h>
+
+#define IN_H 32
+#define IN_W 32
+#define IN_C 3
+#define OUT_C 32
+#define KERNEL_SIZE 3
+#define STRIDE 1
+#define PADDING 1
+#define OUT_H 32
+#define OUT_W 32
+#define UART_TX 0x10000000UL
+
+// UART print functions
+static inline void uart_putc(char c) { *(volatile uint8_t *)UART_TX = (uint8_t)c; }
+static void uart_puts(const char *s)
+{
+    while (*s)
+    {
+        uart_putc(*s++);
+    }
+}
+static void uart_puthex64(uint64_t x)
+{
+    static const char HEX[] = "0123456789ABCDEF";
+    for (int i = 15; i >= 0; i--)
+    {
+        uart_putc(HEX[(x >> (i * 4)) & 0xF]);
+    }
+}
+static inline uint64_t rdcycle(void)
+{
+    uint64_t v;
+    __asm__ volatile("csrr %0, mcycle" : "=r"(v));
+    return v;
+}
+
+int8_t conv0_w[OUT_C][IN_C][KERNEL_SIZE][KERNEL_SIZE];
+int32_t conv0_b[OUT_C];
+
+static inline int8_t relu(int32_t x)
+{
+    if (x < 0)
+    {
+        x = 0;
+    }
+    else if (x > 127)
+    {
+        x = 127;
+    }
+    return (int8_t)x;
+}
+
+// One output pixel over the taps [kh0, kh1) x [kw0, kw1). Always inlined with
+// constant bounds, so every call site below gets its own fully unrolled copy
+// with the padding taps removed at compile time.
+static inline __attribute__((always_inline)) void conv0_px(const int8_t input[IN_C][IN_H][IN_W],
+                                                           int8_t output[OUT_C][OUT_H][OUT_W], int oc, int oh, int ow,
+                                                           int kh0, int kh1, int kw0, int kw1)
+{
+    int32_t acc = conv0_b[oc];
+    for (int ic = 0; ic < IN_C; ic++)
+    {
+        for (int kh = kh0; kh < kh1; kh++)
+        {
+            for (int kw = kw0; kw < kw1; kw++)
+            {
+                acc += (int32_t)input[ic][oh + kh - PADDING][ow + kw - PADDING] * (int32_t)conv0_w[oc][ic][kh][kw];
+            }
+        }
+    }
+    acc >>= 8;
+    output[oc][oh][ow] = relu(acc);
+}
+
+// One output row: left corner/edge, interior columns 1..30, right corner/edge
+static inline __attribute__((always_inline)) void conv0_row(const int8_t input[IN_C][IN_H][IN_W],
+                                                            int8_t output[OUT_C][OUT_H][OUT_W], int oc, int oh,
+                                                            int kh0, int kh1)
+{
+    conv0_px(input, output, oc, oh, 0, kh0, kh1, PADDING, KERNEL_SIZE);
+    for (int ow = PADDING; ow < OUT_W - PADDING; ow++)
+    {
+        conv0_px(input, output, oc, oh, ow, kh0, kh1, 0, KERNEL_SIZE);
+    }
+    conv0_px(input, output, oc, oh, OUT_W - 1, kh0, kh1, 0, KERNEL_SIZE - PADDING);
+}
+
+// conv0 split into a branch-free interior (rows/cols 1..30, 88% of the outputs)
+// and specialised border rows/columns: no padding test and no halo buffer
+void conv0_split(const int8_t input[IN_C][IN_H][IN_W], int8_t output[OUT_C][OUT_H][OUT_W])
+{
+    for (int oc = 0; oc < OUT_C; oc++)
+    {
+        conv0_row(input, output, oc, 0, PADDING, KERNEL_SIZE); // top row
+        for (int oh = PADDING; oh < OUT_H - PADDING; oh++)
+        {
+            conv0_row(input, output, oc, oh, 0, KERNEL_SIZE);
+        }
+        conv0_row(input, output, oc, OUT_H - 1, 0, KERNEL_SIZE - PADDING); // bottom row
+    }
+}
+
+int main() // testing main
+{
+    static int8_t input[IN_C][IN_H][IN_W];
+    static int8_t output[OUT_C][IN_H][IN_W];
+
+    for (int h = 0; h < IN_H; h++)
+        for (int w = 0; w < IN_W; w++)
+        {
+            input[0][h][w] = 1;
+            input[1][h][w] = 2;
+            input[2][h][w] = 3;
+        }
+
+    for (int oc = 0; oc < OUT_C; oc++)
+    {
+        conv0_b[oc] = 0;
+        for (int ic = 0; ic < IN_C; ic++)
+        {
+            for (int kh = 0; kh < KERNEL_SIZE; kh++)
+            {
+                for (int kw = 0; kw < KERNEL_SIZE; kw++)
+                {
+                    conv0_w[oc][ic][kh][kw] = 1;
+                }
+            }
+        }
+    }
+
+    uint64_t c0 = rdcycle();
+    conv0_split(input, output);
+    uint64_t c1 = rdcycle();
+
+    uart_puts("conv0 split cycles: 0x"); // cycles print
+    uart_puthex64(c1 - c0);
+    uart_puts("\n");
+
+    for (;;) // intentional infinite loop to prevent program termination
+    {
+    }
+    return 0;
+}
+
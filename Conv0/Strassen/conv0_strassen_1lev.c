@@ -1,6 +1,8 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "strassen_i8.h"
+
 #define IN_H 32
 #define IN_W 32
 #define IN_C 3
@@ -16,6 +18,15 @@
 
 #define UART_TX 0x10000000UL
 
+// -DCONV0_LIB: no test main; the weights are passed to conv0_strassen_1lev(), the
+// entry point of the conv0 autotuner registry (ResNet-8/conv0_impls.h)
+#ifdef CONV0_LIB
+#define CONV0_STRASSEN_API static
+#else
+#define CONV0_STRASSEN_API
+#endif
+
+#ifndef CONV0_LIB
 static inline void uart_putc(char c) { *(volatile uint8_t *)UART_TX = (uint8_t)c; }
 
 static void uart_puts(const char *s)
@@ -39,6 +50,7 @@ static inline uint64_t rdcycle()
     __asm__ volatile("csrr %0, mcycle" : "=r"(v));
     return v;
 }
+#endif
 
 static int8_t conv0_w[OUT_C][IN_C][KERNEL_SIZE][KERNEL_SIZE];
 static int32_t conv0_b[OUT_C];
@@ -57,62 +69,6 @@ static inline int8_t relu(int32_t acc_q24)
     return (int8_t)q;
 }
 
-// Copy/operations on submatrix 16x16
-static void copy16_i8_to_i16(const int8_t *src, int src_ld, int16_t *dst, int dst_ld)
-{
-    for (int i = 0; i < 16; i++)
-    {
-        for (int j = 0; j < 16; j++)
-        {
-            dst[i * dst_ld + j] = (int16_t)src[i * src_ld + j];
-        }
-    }
-}
-
-static void add16_i16(const int16_t *A, const int16_t *B, int16_t *R, int ld)
-{
-    for (int i = 0; i < 16; i++)
-    {
-        for (int j = 0; j < 16; j++)
-        {
-            R[i * ld + j] = A[i * ld + j] + B[i * ld + j];
-        }
-    }
-}
-
-static void sub16_i16(const int16_t *A, const int16_t *B, int16_t *R, int ld)
-{
-    for (int i = 0; i < 16; i++)
-    {
-        for (int j = 0; j < 16; j++)
-        {
-            R[i * ld + j] = A[i * ld + j] - B[i * ld + j];
-        }
-    }
-}
-
-// C = A * B
-static void mm16_i16_i32(const int16_t *A, const int16_t *B, int32_t *C, int ldA, int ldB, int ldC)
-{
-    int32_t acc;
-    const int16_t *ar;
-    const int16_t *bc;
-    for (int i = 0; i < 16; i++)
-    {
-        for (int j = 0; j < 16; j++)
-        {
-            acc = 0;
-            ar = A + i * ldA;
-            bc = B + j;
-            for (int k = 0; k < 16; k++)
-            {
-                acc += (int32_t)ar[k] * (int32_t)bc[k * ldB];
-            }
-            C[i * ldC + j] = acc;
-        }
-    }
-}
-
 // C += X
 static void add16_i32_inplace(int32_t *C, const int32_t *X, int ld)
 {
@@ -139,51 +95,42 @@ static void sub16_i32_inplace(int32_t *C, const int32_t *X, int ld)
 
 static void strassen_mul(const int8_t A[32][32], const int8_t B[32][32], int32_t C[32][32])
 {
-    static int16_t A11[16][16], A12[16][16], A21[16][16], A22[16][16];
-    static int16_t B11[16][16], B12[16][16], B21[16][16], B22[16][16];
-    static int16_t T1[16][16], T2[16][16];
+    static int8_t T1[16][16], T2[16][16];
+    static uint16_t T1c[16], T2c[16];
     static int32_t M1[16][16], M2[16][16], M3[16][16], M4[16][16], M5[16][16], M6[16][16], M7[16][16];
-
-    copy16_i8_to_i16(&A[0][0], 32, &A11[0][0], 16);
-    copy16_i8_to_i16(&A[0][16], 32, &A12[0][0], 16);
-    copy16_i8_to_i16(&A[16][0], 32, &A21[0][0], 16);
-    copy16_i8_to_i16(&A[16][16], 32, &A22[0][0], 16);
-
-    copy16_i8_to_i16(&B[0][0], 32, &B11[0][0], 16);
-    copy16_i8_to_i16(&B[0][16], 32, &B12[0][0], 16);
-    copy16_i8_to_i16(&B[16][0], 32, &B21[0][0], 16);
-    copy16_i8_to_i16(&B[16][16], 32, &B22[0][0], 16);
+    const int8_t *A11 = &A[0][0], *A12 = &A[0][16], *A21 = &A[16][0], *A22 = &A[16][16];
+    const int8_t *B11 = &B[0][0], *B12 = &B[0][16], *B21 = &B[16][0], *B22 = &B[16][16];
 
     // M1 = (A11 + A22)*(B11 + B22)
-    add16_i16(&A11[0][0], &A22[0][0], &T1[0][0], 16);
-    add16_i16(&B11[0][0], &B22[0][0], &T2[0][0], 16);
-    mm16_i16_i32(&T1[0][0], &T2[0][0], &M1[0][0], 16, 16, 16);
+    add16_i8(A11, A22, 32, &T1[0][0], T1c);
+    add16_i8(B11, B22, 32, &T2[0][0], T2c);
+    mm16_i8_i32(&T1[0][0], 16, T1c, &T2[0][0], 16, T2c, &M1[0][0], 16);
 
     // M2 = (A21 + A22)*B11
-    add16_i16(&A21[0][0], &A22[0][0], &T1[0][0], 16);
-    mm16_i16_i32(&T1[0][0], &B11[0][0], &M2[0][0], 16, 16, 16);
+    add16_i8(A21, A22, 32, &T1[0][0], T1c);
+    mm16_i8_i32(&T1[0][0], 16, T1c, B11, 32, 0, &M2[0][0], 16);
 
     // M3 = A11*(B12 - B22)
-    sub16_i16(&B12[0][0], &B22[0][0], &T2[0][0], 16);
-    mm16_i16_i32(&A11[0][0], &T2[0][0], &M3[0][0], 16, 16, 16);
+    sub16_i8(B12, B22, 32, &T2[0][0], T2c);
+    mm16_i8_i32(A11, 32, 0, &T2[0][0], 16, T2c, &M3[0][0], 16);
 
     // M4 = A22*(B21 - B11)
-    sub16_i16(&B21[0][0], &B11[0][0], &T2[0][0], 16);
-    mm16_i16_i32(&A22[0][0], &T2[0][0], &M4[0][0], 16, 16, 16);
+    sub16_i8(B21, B11, 32, &T2[0][0], T2c);
+    mm16_i8_i32(A22, 32, 0, &T2[0][0], 16, T2c, &M4[0][0], 16);
 
     // M5 = (A11 + A12)*B22
-    add16_i16(&A11[0][0], &A12[0][0], &T1[0][0], 16);
-    mm16_i16_i32(&T1[0][0], &B22[0][0], &M5[0][0], 16, 16, 16);
+    add16_i8(A11, A12, 32, &T1[0][0], T1c);
+    mm16_i8_i32(&T1[0][0], 16, T1c, B22, 32, 0, &M5[0][0], 16);
 
     // M6 = (A21 - A11)*(B11 + B12)
-    sub16_i16(&A21[0][0], &A11[0][0], &T1[0][0], 16);
-    add16_i16(&B11[0][0], &B12[0][0], &T2[0][0], 16);
-    mm16_i16_i32(&T1[0][0], &T2[0][0], &M6[0][0], 16, 16, 16);
+    sub16_i8(A21, A11, 32, &T1[0][0], T1c);
+    add16_i8(B11, B12, 32, &T2[0][0], T2c);
+    mm16_i8_i32(&T1[0][0], 16, T1c, &T2[0][0], 16, T2c, &M6[0][0], 16);
 
     // M7 = (A12 - A22)*(B21 + B22)
-    sub16_i16(&A12[0][0], &A22[0][0], &T1[0][0], 16);
-    add16_i16(&B21[0][0], &B22[0][0], &T2[0][0], 16);
-    mm16_i16_i32(&T1[0][0], &T2[0][0], &M7[0][0], 16, 16, 16);
+    sub16_i8(A12, A22, 32, &T1[0][0], T1c);
+    add16_i8(B21, B22, 32, &T2[0][0], T2c);
+    mm16_i8_i32(&T1[0][0], 16, T1c, &T2[0][0], 16, T2c, &M7[0][0], 16);
 
     // Combine into C
     for (int i = 0; i < 16; i++)
@@ -260,7 +207,7 @@ static void buildB(const int8_t input[IN_C][IN_H][IN_W], int tile_base, int8_t B
     }
 }
 
-void conv0_strassen(const int8_t input[IN_C][IN_H][IN_W], int8_t output[OUT_C][OUT_H][OUT_W])
+CONV0_STRASSEN_API void conv0_strassen(const int8_t input[IN_C][IN_H][IN_W], int8_t output[OUT_C][OUT_H][OUT_W])
 {
     int lin, oh, ow;
     int32_t acc, b;
@@ -291,6 +238,27 @@ void conv0_strassen(const int8_t input[IN_C][IN_H][IN_W], int8_t output[OUT_C][O
     }
 }
 
+#ifdef CONV0_LIB
+void conv0_strassen_1lev(const int8_t input[IN_C][IN_H][IN_W], int8_t output[OUT_C][OUT_H][OUT_W],
+                         const int8_t w[OUT_C][IN_C][KERNEL_SIZE][KERNEL_SIZE], const int32_t b[OUT_C])
+{
+    for (int oc = 0; oc < OUT_C; oc++)
+    {
+        conv0_b[oc] = b[oc];
+        for (int ic = 0; ic < IN_C; ic++)
+        {
+            for (int kh = 0; kh < KERNEL_SIZE; kh++)
+            {
+                for (int kw = 0; kw < KERNEL_SIZE; kw++)
+                {
+                    conv0_w[oc][ic][kh][kw] = w[oc][ic][kh][kw];
+                }
+            }
+        }
+    }
+    conv0_strassen(input, output);
+}
+#else
 int main()
 {
     static int8_t input[IN_C][IN_H][IN_W];
@@ -334,3 +302,4 @@ int main()
         ;
     return 0;
 }
+#endif
@@ -1,6 +1,8 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "strassen_i8.h"
+
 #define IN_H 32
 #define IN_W 32
 #define IN_C 3
@@ -14,7 +16,15 @@
 #define QSHIFT 8 
 #define UART_TX 0x10000000UL
 
+// -DCONV0_LIB: no test main; the weights are passed to conv0_strassen_2lev(), the
+// entry point of the conv0 autotuner registry (ResNet-8/conv0_impls.h)
+#ifdef CONV0_LIB
+#define CONV0_STRASSEN_API static
+#else
+#define CONV0_STRASSEN_API
+#endif
 
+#ifndef CONV0_LIB
 static inline void uart_putc(char c) { *(volatile uint8_t *)UART_TX = (uint8_t)c; }
 static void uart_puts(const char *s)
 {
@@ -37,6 +47,7 @@ static inline uint64_t rdcycle()
     __asm__ volatile("csrr %0, mcycle" : "=r"(v));
     return v;
 }
+#endif
 
 static int8_t conv0_w[OUT_C][IN_C][KERNEL_SIZE][KERNEL_SIZE];
 static int32_t conv0_b[OUT_C];
@@ -55,36 +66,6 @@ static inline int8_t relu(int32_t acc)
     return (int8_t)q;
 }
 
-static void copy16_i8_to_i16(const int8_t *src, int src_ld, int16_t *dst, int dst_ld)
-{
-    for (int i = 0; i < 16; i++)
-    {
-        for (int j = 0; j < 16; j++)
-        {
-            dst[i * dst_ld + j] = (int16_t)src[i * src_ld + j];
-        }
-    }
-}
-static void add16_i16(const int16_t *A, const int16_t *B, int16_t *R, int ld)
-{
-    for (int i = 0; i < 16; i++)
-    {
-        for (int j = 0; j < 16; j++)
-        {
-            R[i * ld + j] = A[i * ld + j] + B[i * ld + j];
-        }
-    }
-}
-static void sub16_i16(const int16_t *A, const int16_t *B, int16_t *R, int ld)
-{
-    for (int i = 0; i < 16; i++)
-    {
-        for (int j = 0; j < 16; j++)
-        {
-            R[i * ld + j] = A[i * ld + j] - B[i * ld + j];
-        }
-    }
-}
 static void add8_i16(const int16_t *A, const int16_t *B, int16_t *R, int ld)
 {
     for (int i = 0; i < 8; i++)
@@ -128,8 +109,11 @@ static void mm8_i16_i32(const int16_t *A, const int16_t *B, int32_t *C, int ldA,
     }
 }
 
-//Strassen 16×16 used as "base multiplication” at 32 level
-static void strassen16_level1(const int16_t A[16][16], const int16_t B[16][16], int32_t C[16][16])
+//Strassen 16×16 used as "base multiplication” at 32 level. A and B are the int8
+// operands of the 32 level with their carry planes (0: plain quadrant); a second
+// round of sums needs 10 bits, so the 8×8 quadrants of this level are widened to int16
+static void strassen16_level1(const int8_t *A, int ldA, const uint16_t *Ac, const int8_t *B, int ldB,
+                              const uint16_t *Bc, int32_t C[16][16])
 {
 
     static int16_t A11[8][8], A12[8][8], A21[8][8], A22[8][8];
@@ -141,14 +125,14 @@ static void strassen16_level1(const int16_t A[16][16], const int16_t B[16][16],
     {
         for (int j = 0; j < 8; j++)
         {
-            A11[i][j] = A[i][j];
-            A12[i][j] = A[i][8 + j];
-            A21[i][j] = A[8 + i][j];
-            A22[i][j] = A[8 + i][8 + j];
-            B11[i][j] = B[i][j];
-            B12[i][j] = B[i][8 + j];
-            B21[i][j] = B[8 + i][j];
-            B22[i][j] = B[8 + i][8 + j];
+            A11[i][j] = (int16_t)op16_at(A, ldA, Ac, i, j);
+            A12[i][j] = (int16_t)op16_at(A, ldA, Ac, i, 8 + j);
+            A21[i][j] = (int16_t)op16_at(A, ldA, Ac, 8 + i, j);
+            A22[i][j] = (int16_t)op16_at(A, ldA, Ac, 8 + i, 8 + j);
+            B11[i][j] = (int16_t)op16_at(B, ldB, Bc, i, j);
+            B12[i][j] = (int16_t)op16_at(B, ldB, Bc, i, 8 + j);
+            B21[i][j] = (int16_t)op16_at(B, ldB, Bc, 8 + i, j);
+            B22[i][j] = (int16_t)op16_at(B, ldB, Bc, 8 + i, 8 + j);
         }
     }
 
@@ -193,45 +177,43 @@ static void strassen16_level1(const int16_t A[16][16], const int16_t B[16][16],
 // Strassen 32×32 with 2 levels: 32→16 uses Strassen; 16 uses Strassen→8
 static void strassen32_level2(const int8_t A[32][32], const int8_t B[32][32], int32_t C[32][32])
 {
-    static int16_t A11[16][16], A12[16][16], A21[16][16], A22[16][16];
-    static int16_t B11[16][16], B12[16][16], B21[16][16], B22[16][16];
-    static int16_t T1[16][16], T2[16][16];
+    static int8_t T1[16][16], T2[16][16];
+    static uint16_t T1c[16], T2c[16];
     static int32_t M1[16][16], M2[16][16], M3[16][16], M4[16][16], M5[16][16], M6[16][16], M7[16][16];
+    const int8_t *A11 = &A[0][0], *A12 = &A[0][16], *A21 = &A[16][0], *A22 = &A[16][16];
+    const int8_t *B11 = &B[0][0], *B12 = &B[0][16], *B21 = &B[16][0], *B22 = &B[16][16];
 
-    copy16_i8_to_i16(&A[0][0], 32, &A11[0][0], 16);
-    copy16_i8_to_i16(&A[0][16], 32, &A12[0][0], 16);
-    copy16_i8_to_i16(&A[16][0], 32, &A21[0][0], 16);
-    copy16_i8_to_i16(&A[16][16], 32, &A22[0][0], 16);
-
-    copy16_i8_to_i16(&B[0][0], 32, &B11[0][0], 16);
-    copy16_i8_to_i16(&B[0][16], 32, &B12[0][0], 16);
-    copy16_i8_to_i16(&B[16][0], 32, &B21[0][0], 16);
-    copy16_i8_to_i16(&B[16][16], 32, &B22[0][0], 16);
+    // M1..M7 at 32 level: every 16×16 product is Strassen16 (which uses an 8×8 base)
+    // M1 = (A11 + A22)*(B11 + B22)
+    add16_i8(A11, A22, 32, &T1[0][0], T1c);
+    add16_i8(B11, B22, 32, &T2[0][0], T2c);
+    strassen16_level1(&T1[0][0], 16, T1c, &T2[0][0], 16, T2c, M1);
 
-    // M1..M7 at 32 level: every 16×16 product is Strassen16 (which uses an 8×8 base) 
-    add16_i16(&A11[0][0], &A22[0][0], &T1[0][0], 16);
-    add16_i16(&B11[0][0], &B22[0][0], &T2[0][0], 16);
-    strassen16_level1((const int16_t (*)[16])T1, (const int16_t (*)[16])T2, (int32_t (*)[16])M1);
+    // M2 = (A21 + A22)*B11
+    add16_i8(A21, A22, 32, &T1[0][0], T1c);
+    strassen16_level1(&T1[0][0], 16, T1c, B11, 32, 0, M2);
 
-    add16_i16(&A21[0][0], &A22[0][0], &T1[0][0], 16);
-    strassen16_level1((const int16_t (*)[16])T1, (const int16_t (*)[16])B11, (int32_t (*)[16])M2);
+    // M3 = A11*(B12 - B22)
+    sub16_i8(B12, B22, 32, &T2[0][0], T2c);
+    strassen16_level1(A11, 32, 0, &T2[0][0], 16, T2c, M3);
 
-    sub16_i16(&B12[0][0], &B22[0][0], &T2[0][0], 16);
-    strassen16_level1((const int16_t (*)[16])A11, (const int16_t (*)[16])T2, (int32_t (*)[16])M3);
+    // M4 = A22*(B21 - B11)
+    sub16_i8(B21, B11, 32, &T2[0][0], T2c);
+    strassen16_level1(A22, 32, 0, &T2[0][0], 16, T2c, M4);
 
-    sub16_i16(&B21[0][0], &B11[0][0], &T2[0][0], 16);
-    strassen16_level1((const int16_t (*)[16])A22, (const int16_t (*)[16])T2, (int32_t (*)[16])M4);
+    // M5 = (A11 + A12)*B22
+    add16_i8(A11, A12, 32, &T1[0][0], T1c);
+    strassen16_level1(&T1[0][0], 16, T1c, B22, 32, 0, M5);
 
-    add16_i16(&A11[0][0], &A12[0][0], &T1[0][0], 16);
-    strassen16_level1((const int16_t (*)[16])T1, (const int16_t (*)[16])B22, (int32_t (*)[16])M5);
+    // M6 = (A21 - A11)*(B11 + B12)
+    sub16_i8(A21, A11, 32, &T1[0][0], T1c);
+    add16_i8(B11, B12, 32, &T2[0][0], T2c);
+    strassen16_level1(&T1[0][0], 16, T1c, &T2[0][0], 16, T2c, M6);
 
-    sub16_i16(&A21[0][0], &A11[0][0], &T1[0][0], 16);
-    add16_i16(&B11[0][0], &B12[0][0], &T2[0][0], 16);
-    strassen16_level1((const int16_t (*)[16])T1, (const int16_t (*)[16])T2, (int32_t (*)[16])M6);
-
-    sub16_i16(&A12[0][0], &A22[0][0], &T1[0][0], 16);
-    add16_i16(&B21[0][0], &B22[0][0], &T2[0][0], 16);
-    strassen16_level1((const int16_t (*)[16])T1, (const int16_t (*)[16])T2, (int32_t (*)[16])M7);
+    // M7 = (A12 - A22)*(B21 + B22)
+    sub16_i8(A12, A22, 32, &T1[0][0], T1c);
+    add16_i8(B21, B22, 32, &T2[0][0], T2c);
+    strassen16_level1(&T1[0][0], 16, T1c, &T2[0][0], 16, T2c, M7);
 
     // Final recomp in C (32×32)
     for (int i = 0; i < 16; i++)
@@ -305,7 +287,7 @@ static void buildB(const int8_t input[IN_C][IN_H][IN_W], int oh, int ow, int8_t
     }
 }
 
-void conv0_strassen(const int8_t input[IN_C][IN_H][IN_W], int8_t output[OUT_C][OUT_H][OUT_W])
+CONV0_STRASSEN_API void conv0_strassen(const int8_t input[IN_C][IN_H][IN_W], int8_t output[OUT_C][OUT_H][OUT_W])
 {
     static int8_t A[32][32];
     static int8_t B[32][32];
@@ -333,6 +315,27 @@ void conv0_strassen(const int8_t input[IN_C][IN_H][IN_W], int8_t output[OUT_C][O
     }
 }
 
+#ifdef CONV0_LIB
+void conv0_strassen_2lev(const int8_t input[IN_C][IN_H][IN_W], int8_t output[OUT_C][OUT_H][OUT_W],
+                         const int8_t w[OUT_C][IN_C][KERNEL_SIZE][KERNEL_SIZE], const int32_t b[OUT_C])
+{
+    for (int oc = 0; oc < OUT_C; oc++)
+    {
+        conv0_b[oc] = b[oc];
+        for (int ic = 0; ic < IN_C; ic++)
+        {
+            for (int kh = 0; kh < KERNEL_SIZE; kh++)
+            {
+                for (int kw = 0; kw < KERNEL_SIZE; kw++)
+                {
+                    conv0_w[oc][ic][kh][kw] = w[oc][ic][kh][kw];
+                }
+            }
+        }
+    }
+    conv0_strassen(input, output);
+}
+#else
 int main()
 {
     static int8_t input[IN_C][IN_H][IN_W];
@@ -375,3 +378,4 @@ int main()
         ;
     return 0;
 }
+#endif
@@ -0,0 +1,113 @@
+// int8 Strassen operands with carry planes, shared by conv0_strassen_1lev.c,
+// conv0_strassen_2lev.c, conv0_strassen_rect.c and ResNet-8/resnet8_strassen.c.
+//
+// Strassen operands stay int8. A sum or difference of two int8 quadrants needs
+// 9 bits, so only its low byte is stored (two's complement wrap) and bit j of
+// carry[i] flags the elements of row i that wrapped; the lost 256 always has the
+// opposite sign of the stored byte. mm16_i8_i32() multiplies the low bytes and
+// adds the flagged elements back as a sparse correction, so every M stays exact
+// while the pre-additions and the leaf products move bytes instead of int16.
+#ifndef STRASSEN_I8_H
+#define STRASSEN_I8_H
+
+#include <stdint.h>
+
+// The 256 lost by the wrap of a stored low byte
+static inline int32_t carry_of(int8_t lo) { return lo < 0 ? 256 : -256; }
+
+// Element (i, j) of an operand with carry plane c (0: plain int8 quadrant)
+static inline int32_t op16_at(const int8_t *X, int ld, const uint16_t *c, int i, int j)
+{
+    int8_t lo = X[i * ld + j];
+    return (c && (c[i] >> j & 1)) ? lo + carry_of(lo) : lo;
+}
+
+// R = A + B on 16x16 quadrants read in place (leading dimension ld); R is dense
+static inline void add16_i8(const int8_t *A, const int8_t *B, int ld, int8_t *R, uint16_t *carry)
+{
+    int32_t s;
+    uint32_t m;
+    for (int i = 0; i < 16; i++)
+    {
+        m = 0;
+        for (int j = 0; j < 16; j++)
+        {
+            s = A[i * ld + j] + B[i * ld + j];
+            R[i * 16 + j] = (int8_t)s;
+            m |= (uint32_t)(s != (int8_t)s) << j;
+        }
+        carry[i] = (uint16_t)m;
+    }
+}
+
+static inline void sub16_i8(const int8_t *A, const int8_t *B, int ld, int8_t *R, uint16_t *carry)
+{
+    int32_t s;
+    uint32_t m;
+    for (int i = 0; i < 16; i++)
+    {
+        m = 0;
+        for (int j = 0; j < 16; j++)
+        {
+            s = A[i * ld + j] - B[i * ld + j];
+            R[i * 16 + j] = (int8_t)s;
+            m |= (uint32_t)(s != (int8_t)s) << j;
+        }
+        carry[i] = (uint16_t)m;
+    }
+}
+
+// C = A * B; Ac/Bc are the carry planes of A and B (0 for a plain quadrant)
+static inline void mm16_i8_i32(const int8_t *A, int ldA, const uint16_t *Ac, const int8_t *B, int ldB,
+                               const uint16_t *Bc, int32_t *C, int ldC)
+{
+    int32_t acc, d;
+    const int8_t *ar, *bc;
+    for (int i = 0; i < 16; i++)
+    {
+        ar = A + i * ldA;
+        for (int j = 0; j < 16; j++)
+        {
+            bc = B + j;
+            acc = 0;
+            for (int k = 0; k < 16; k++)
+            {
+                acc += (int32_t)ar[k] * (int32_t)bc[k * ldB];
+            }
+            C[i * ldC + j] = acc;
+        }
+    }
+
+    // Wrapped elements of A, against the full B: C[i][:] += d * B[k][:]
+    for (int i = 0; Ac && i < 16; i++)
+    {
+        for (int k = 0; Ac[i] >> k; k++)
+        {
+            if (Ac[i] >> k & 1)
+            {
+                d = carry_of(A[i * ldA + k]);
+                for (int j = 0; j < 16; j++)
+                {
+                    C[i * ldC + j] += d * op16_at(B, ldB, Bc, k, j);
+                }
+            }
+        }
+    }
+    // Wrapped elements of B, against the stored bytes of A: C[:][j] += A[:][k] * d
+    for (int k = 0; Bc && k < 16; k++)
+    {
+        for (int j = 0; Bc[k] >> j; j++)
+        {
+            if (Bc[k] >> j & 1)
+            {
+                d = carry_of(B[k * ldB + j]);
+                for (int i = 0; i < 16; i++)
+                {
+                    C[i * ldC + j] += (int32_t)A[i * ldA + k] * d;
+                }
+            }
+        }
+    }
+}
+
+#endif // STRASSEN_I8_H
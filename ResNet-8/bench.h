@@ -0,0 +1,111 @@
+// Benchmark runner for the bare-metal variants (QEMU virt).
+// Build a variant with -DBENCH and its main() runs
+//
+//   BENCH_WARMUP untimed inferences (caches, branch predictors, first-touch),
+//   BENCH_ITERS  timed inferences, each sampled with mcycle and minstret,
+//
+// then prints one line
+//
+//   bench,<name>,warmup=W,iters=N,cyc_min=..,cyc_med=..,cyc_p99=..,instret_med=..,mtime=..,inf_s=X.XXX,status=S
+//
+// and powers the machine off through the virt test finisher, so QEMU exits with
+// status S: 0 = ok, BENCH_ERR_NONDET = the output changed between iterations.
+// inf_s is N / elapsed mtime (10 MHz on virt); with -icount it tracks the virtual
+// clock, without it the host wall clock. Tools/bench.py sweeps variants in batch.
+#ifndef RESNET8_BENCH_H
+#define RESNET8_BENCH_H
+
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifndef BENCH_WARMUP
+#define BENCH_WARMUP 2
+#endif
+#ifndef BENCH_ITERS
+#define BENCH_ITERS 20
+#endif
+#define BENCH_MAX_ITERS 256
+_Static_assert(BENCH_ITERS >= 1 && BENCH_ITERS <= BENCH_MAX_ITERS, "BENCH_ITERS out of range");
+
+#define BENCH_OK 0
+#define BENCH_ERR_NONDET 1
+
+static uint32_t bench_checksum(const int8_t *p, int n)
+{
+    uint32_t h = 2166136261u; // FNV-1a
+    for (int i = 0; i < n; i++)
+    {
+        h = (h ^ (uint8_t)p[i]) * 16777619u;
+    }
+    return h;
+}
+
+static void bench_sort(uint64_t *v, int n)
+{
+    for (int i = 1; i < n; i++)
+    {
+        uint64_t x = v[i];
+        int j = i - 1;
+        while (j >= 0 && v[j] > x)
+        {
+            v[j + 1] = v[j];
+            j--;
+        }
+        v[j + 1] = x;
+    }
+}
+
+// Runs `infer` (one inference writing out[0..out_len)), prints the report and exits
+static void bench_run(const char *name, void (*infer)(void), const int8_t *out, int out_len)
+{
+    static uint64_t cyc[BENCH_ITERS], ins[BENCH_ITERS];
+    uint64_t c0, i0, m0, m1, mtime;
+    uint32_t ref = 0;
+    int status = BENCH_OK;
+
+    for (int i = 0; i < BENCH_WARMUP; i++)
+    {
+        infer();
+    }
+
+    m0 = read_mtime64();
+    for (int i = 0; i < BENCH_ITERS; i++)
+    {
+        i0 = read_minstret64();
+        c0 = read_mcycle64();
+        infer();
+        cyc[i] = read_mcycle64() - c0;
+        ins[i] = read_minstret64() - i0;
+        if (i == 0)
+        {
+            ref = bench_checksum(out, out_len);
+        }
+        else if (bench_checksum(out, out_len) != ref)
+        {
+            status = BENCH_ERR_NONDET;
+        }
+    }
+    m1 = read_mtime64();
+    mtime = m1 - m0;
+
+    bench_sort(cyc, BENCH_ITERS);
+    bench_sort(ins, BENCH_ITERS);
+
+    platform_puts("bench,");
+    platform_puts(name);
+    platform_field("warmup", BENCH_WARMUP);
+    platform_field("iters", BENCH_ITERS);
+    platform_field("cyc_min", cyc[0]);
+    platform_field("cyc_med", cyc[BENCH_ITERS / 2]);
+    platform_field("cyc_p99", cyc[(BENCH_ITERS * 99 + 99) / 100 - 1]);
+    platform_field("instret_med", ins[BENCH_ITERS / 2]);
+    platform_field("mtime", mtime);
+    platform_rate("inf_s", BENCH_ITERS, mtime);
+    platform_field("status", status);
+    platform_putc('\n');
+
+    platform_exit(status);
+}
+
+#endif // RESNET8_BENCH_H
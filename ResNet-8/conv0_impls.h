@@ -0,0 +1,202 @@
+// conv0 candidates for the startup autotuner (tune.h), -DTUNE in resnet8.c.
+// Every candidate has the signature of the C conv0 and gets the same planar
+// int8 input, OIHW weights and bias; the adapters build whatever layout the
+// hand-written kernel wants (zero halo, RGBX words) inside the timed call, so
+// the comparison is end to end. Candidates whose object is not linked are
+// weak symbols that read as 0 and are reported as absent:
+//
+//   Conv0/Assembly RISC-V/Conv0_vN.s   assembled with --defsym CONV0_LIB=1
+//   Conv0/Strassen/conv0_strassen_*.c  compiled with -DCONV0_LIB
+//
+// Needs IN_C.., OUT_C.., K and the C conv0 of resnet8.c (CHW layout).
+#ifndef RESNET8_CONV0_IMPLS_H
+#define RESNET8_CONV0_IMPLS_H
+
+#include "tune.h"
+
+#ifdef LAYOUT_NHWC
+#error "conv0 candidates are CHW kernels: build -DTUNE without LAYOUT_NHWC"
+#endif
+
+typedef void (*conv0_fn_t)(const int8_t in[IN_C][IN_H][IN_W], int8_t out[OUT_C][OUT_H][OUT_W],
+                           const int8_t w[OUT_C][IN_C][K][K], const int32_t b[OUT_C]);
+
+// Assembly kernels: a0 = input, a1 = output, a2 = weights, a3 = bias
+extern void conv0_v1(void) __attribute__((weak)); // unpadded planar input
+extern void conv0_v2(void) __attribute__((weak)); // planar halo [3][34][34]
+extern void conv0_v3(void) __attribute__((weak)); // planar halo, 2 oc x 4 ow tiles
+extern void conv0_v4(void) __attribute__((weak)); // RGBX halo [34][34] words, RGBX weights
+extern void conv0_strassen_1lev(const int8_t in[IN_C][IN_H][IN_W], int8_t out[OUT_C][OUT_H][OUT_W],
+                                const int8_t w[OUT_C][IN_C][K][K], const int32_t b[OUT_C]) __attribute__((weak));
+extern void conv0_strassen_2lev(const int8_t in[IN_C][IN_H][IN_W], int8_t out[OUT_C][OUT_H][OUT_W],
+                                const int8_t w[OUT_C][IN_C][K][K], const int32_t b[OUT_C]) __attribute__((weak));
+extern void conv0_strassen_rect(const int8_t in[IN_C][IN_H][IN_W], int8_t out[OUT_C][OUT_H][OUT_W],
+                                const int8_t w[OUT_C][IN_C][K][K], const int32_t b[OUT_C]) __attribute__((weak));
+
+// The asm kernels use s0..s11 without saving them: call them through a shim
+// that does, with the kernel address in a4. Slots are XLEN wide (rv64 or rv32);
+// the frame is 16 slots to keep sp 16-byte aligned.
+void conv0_asm_call(const void *a0, void *a1, const void *a2, const void *a3, tune_fn_t kernel);
+#if __riscv_xlen == 32
+#define CONV0_SHIM_SAVE "    sw   "
+#define CONV0_SHIM_LOAD "    lw   "
+#define CONV0_SHIM_SLOT "4"
+#else
+#define CONV0_SHIM_SAVE "    sd   "
+#define CONV0_SHIM_LOAD "    ld   "
+#define CONV0_SHIM_SLOT "8"
+#endif
+__asm__(".text\n"
+        ".globl conv0_asm_call\n"
+        ".type conv0_asm_call, @function\n"
+        "conv0_asm_call:\n"
+        "    addi sp, sp, -16*" CONV0_SHIM_SLOT "\n"
+        CONV0_SHIM_SAVE "ra, 13*" CONV0_SHIM_SLOT "(sp)\n"
+        CONV0_SHIM_SAVE "s0, 12*" CONV0_SHIM_SLOT "(sp)\n"
+        CONV0_SHIM_SAVE "s1, 11*" CONV0_SHIM_SLOT "(sp)\n"
+        CONV0_SHIM_SAVE "s2, 10*" CONV0_SHIM_SLOT "(sp)\n"
+        CONV0_SHIM_SAVE "s3, 9*" CONV0_SHIM_SLOT "(sp)\n"
+        CONV0_SHIM_SAVE "s4, 8*" CONV0_SHIM_SLOT "(sp)\n"
+        CONV0_SHIM_SAVE "s5, 7*" CONV0_SHIM_SLOT "(sp)\n"
+        CONV0_SHIM_SAVE "s6, 6*" CONV0_SHIM_SLOT "(sp)\n"
+        CONV0_SHIM_SAVE "s7, 5*" CONV0_SHIM_SLOT "(sp)\n"
+        CONV0_SHIM_SAVE "s8, 4*" CONV0_SHIM_SLOT "(sp)\n"
+        CONV0_SHIM_SAVE "s9, 3*" CONV0_SHIM_SLOT "(sp)\n"
+        CONV0_SHIM_SAVE "s10, 2*" CONV0_SHIM_SLOT "(sp)\n"
+        CONV0_SHIM_SAVE "s11, 1*" CONV0_SHIM_SLOT "(sp)\n"
+        "    jalr a4\n"
+        CONV0_SHIM_LOAD "ra, 13*" CONV0_SHIM_SLOT "(sp)\n"
+        CONV0_SHIM_LOAD "s0, 12*" CONV0_SHIM_SLOT "(sp)\n"
+        CONV0_SHIM_LOAD "s1, 11*" CONV0_SHIM_SLOT "(sp)\n"
+        CONV0_SHIM_LOAD "s2, 10*" CONV0_SHIM_SLOT "(sp)\n"
+        CONV0_SHIM_LOAD "s3, 9*" CONV0_SHIM_SLOT "(sp)\n"
+        CONV0_SHIM_LOAD "s4, 8*" CONV0_SHIM_SLOT "(sp)\n"
+        CONV0_SHIM_LOAD "s5, 7*" CONV0_SHIM_SLOT "(sp)\n"
+        CONV0_SHIM_LOAD "s6, 6*" CONV0_SHIM_SLOT "(sp)\n"
+        CONV0_SHIM_LOAD "s7, 5*" CONV0_SHIM_SLOT "(sp)\n"
+        CONV0_SHIM_LOAD "s8, 4*" CONV0_SHIM_SLOT "(sp)\n"
+        CONV0_SHIM_LOAD "s9, 3*" CONV0_SHIM_SLOT "(sp)\n"
+        CONV0_SHIM_LOAD "s10, 2*" CONV0_SHIM_SLOT "(sp)\n"
+        CONV0_SHIM_LOAD "s11, 1*" CONV0_SHIM_SLOT "(sp)\n"
+        "    addi sp, sp, 16*" CONV0_SHIM_SLOT "\n"
+        "    ret\n"
+        ".size conv0_asm_call, .-conv0_asm_call\n");
+
+// Halo borders stay zero (.bss); only the interior is rewritten per call
+static int8_t conv0_halo[IN_C][IN_H + 2][IN_W + 2];
+static uint32_t conv0_halo_rgbx[IN_H + 2][IN_W + 2] __attribute__((aligned(8)));
+static uint32_t conv0_w_rgbx[OUT_C][K][K];
+
+static void conv0_pad_halo(const int8_t in[IN_C][IN_H][IN_W])
+{
+    for (int c = 0; c < IN_C; c++)
+    {
+        for (int h = 0; h < IN_H; h++)
+        {
+            for (int w = 0; w < IN_W; w++)
+            {
+                conv0_halo[c][h + 1][w + 1] = in[c][h][w];
+            }
+        }
+    }
+}
+
+static inline uint32_t conv0_rgbx(int8_t r, int8_t g, int8_t b)
+{
+    return (uint32_t)(uint8_t)r | (uint32_t)(uint8_t)g << 8 | (uint32_t)(uint8_t)b << 16;
+}
+
+static void conv0_asm_v1(const int8_t in[IN_C][IN_H][IN_W], int8_t out[OUT_C][OUT_H][OUT_W],
+                         const int8_t w[OUT_C][IN_C][K][K], const int32_t b[OUT_C])
+{
+    conv0_asm_call(in, out, w, b, conv0_v1);
+}
+
+static void conv0_asm_v2(const int8_t in[IN_C][IN_H][IN_W], int8_t out[OUT_C][OUT_H][OUT_W],
+                         const int8_t w[OUT_C][IN_C][K][K], const int32_t b[OUT_C])
+{
+    conv0_pad_halo(in);
+    conv0_asm_call(conv0_halo, out, w, b, conv0_v2);
+}
+
+static void conv0_asm_v3(const int8_t in[IN_C][IN_H][IN_W], int8_t out[OUT_C][OUT_H][OUT_W],
+                         const int8_t w[OUT_C][IN_C][K][K], const int32_t b[OUT_C])
+{
+    conv0_pad_halo(in);
+    conv0_asm_call(conv0_halo, out, w, b, conv0_v3);
+}
+
+static void conv0_asm_v4(const int8_t in[IN_C][IN_H][IN_W], int8_t out[OUT_C][OUT_H][OUT_W],
+                         const int8_t w[OUT_C][IN_C][K][K], const int32_t b[OUT_C])
+{
+    for (int h = 0; h < IN_H; h++)
+    {
+        for (int x = 0; x < IN_W; x++)
+        {
+            conv0_halo_rgbx[h + 1][x + 1] = conv0_rgbx(in[0][h][x], in[1][h][x], in[2][h][x]);
+        }
+    }
+    for (int oc = 0; oc < OUT_C; oc++)
+    {
+        for (int kh = 0; kh < K; kh++)
+        {
+            for (int kw = 0; kw < K; kw++)
+            {
+                conv0_w_rgbx[oc][kh][kw] = conv0_rgbx(w[oc][0][kh][kw], w[oc][1][kh][kw], w[oc][2][kh][kw]);
+            }
+        }
+    }
+    conv0_asm_call(conv0_halo_rgbx, out, conv0_w_rgbx, b, conv0_v4);
+}
+
+// Candidate 0 is the reference every other output is checked against
+static const tune_cand_t conv0_cands[] = {
+    {"c_direct", (tune_fn_t)conv0, (tune_fn_t)conv0},
+    {"asm_v1", (tune_fn_t)conv0_asm_v1, conv0_v1},
+    {"asm_v2", (tune_fn_t)conv0_asm_v2, conv0_v2},
+    {"asm_v3", (tune_fn_t)conv0_asm_v3, conv0_v3},
+    {"asm_v4", (tune_fn_t)conv0_asm_v4, conv0_v4},
+    {"strassen_1lev", (tune_fn_t)conv0_strassen_1lev, (tune_fn_t)conv0_strassen_1lev},
+    {"strassen_2lev", (tune_fn_t)conv0_strassen_2lev, (tune_fn_t)conv0_strassen_2lev},
+    {"strassen_rect", (tune_fn_t)conv0_strassen_rect, (tune_fn_t)conv0_strassen_rect},
+};
+#define CONV0_NCANDS ((int)(sizeof(conv0_cands) / sizeof(conv0_cands[0])))
+
+// -DCONV0_PLAN='"name"': bind that candidate (a plan line of an earlier run)
+#ifndef CONV0_PLAN
+#define CONV0_PLAN 0
+#endif
+
+static conv0_fn_t conv0_impl = conv0; // resnet8() dispatch
+
+static int8_t conv0_cal_in[IN_C][IN_H][IN_W];
+static int8_t conv0_cal_out[OUT_C][OUT_H][OUT_W];
+static int8_t conv0_cal_ref[OUT_C][OUT_H][OUT_W];
+static const int8_t (*conv0_cal_w)[IN_C][K][K];
+static const int32_t *conv0_cal_b;
+
+static void conv0_cal_invoke(tune_fn_t fn)
+{
+    ((conv0_fn_t)fn)(conv0_cal_in, conv0_cal_out, conv0_cal_w, conv0_cal_b);
+}
+
+// Call once the weights are loaded: calibrates on the real weights and a
+// pseudo-random input (full int8 range, so saturation paths are exercised too)
+static void conv0_tune(const int8_t w[OUT_C][IN_C][K][K], const int32_t b[OUT_C])
+{
+    uint32_t s = 1;
+    int8_t *p = &conv0_cal_in[0][0][0];
+    for (int i = 0; i < IN_C * IN_H * IN_W; i++)
+    {
+        s = s * 1664525u + 1013904223u;
+        p[i] = (int8_t)(s >> 24);
+    }
+    conv0_cal_w = w;
+    conv0_cal_b = b;
+
+    int pick = tune_pick("conv0", conv0_cands, CONV0_NCANDS, conv0_cal_invoke, &conv0_cal_out[0][0][0],
+                         &conv0_cal_ref[0][0][0], (int)sizeof(conv0_cal_out), CONV0_PLAN);
+    conv0_impl = (conv0_fn_t)conv0_cands[pick].fn;
+}
+
+#endif // RESNET8_CONV0_IMPLS_H
@@ -0,0 +1,248 @@
+// Dataset runner over RISC-V semihosting (qemu-system-riscv64 -semihosting).
+// Built with -DDATASET, a variant replaces its all-ones test weights by a real
+// weight blob and classifies a file of test images against reference labels,
+// all read from the host through semihosting calls (SYS_OPEN/SYS_FLEN/SYS_READ):
+// no network, no file system on the target. Tools/dataset.py writes the files:
+//
+//   DATASET_WEIGHTS  weight blob: the variant's tensors concatenated in its table
+//                    order (OIHW int8 weights, int32 biases, little-endian)
+//   DATASET_IMAGES   N frames of [3][32][32] uint8 pixels, planar (CIFAR-10 order)
+//   DATASET_LABELS   N bytes, the class index of each frame
+//
+// Frames are streamed DATASET_BATCH at a time; only the inference is timed
+// (mcycle and mtime, the host I/O is accounted separately as io_mtime). The run
+// prints one line
+//
+//   dataset,<name>,images=N,correct=C,acc=XX.XX,cyc_avg=..,mtime=..,io_mtime=..,inf_s=X.XXX,status=S
+//
+// and powers the machine off through the virt test finisher with status S:
+// 0 = ok, DATASET_ERR_IO = a file is missing or has the wrong size (a
+// `dataset,<name>,file=<path>` line names it).
+// A variant that defines DATASET_REPORT(name) gets it called after the line,
+// with the last frame still in its input buffers.
+#ifndef RESNET8_DATASET_H
+#define RESNET8_DATASET_H
+
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifndef DATASET_WEIGHTS
+#define DATASET_WEIGHTS "weights.bin"
+#endif
+#ifndef DATASET_IMAGES
+#define DATASET_IMAGES "images.bin"
+#endif
+#ifndef DATASET_LABELS
+#define DATASET_LABELS "labels.bin"
+#endif
+#ifndef DATASET_BATCH
+#define DATASET_BATCH 16 // frames per SYS_READ (48 KiB)
+#endif
+#ifndef DATASET_MAX
+#define DATASET_MAX 0 // stop after this many frames, 0 = whole file
+#endif
+
+#define DATASET_FRAME (3 * 32 * 32)
+
+#define DATASET_OK 0
+#define DATASET_ERR_IO 1
+
+// Semihosting operations (RISC-V semihosting = ARM semihosting numbers)
+#define SEMIHOST_SYS_OPEN 0x01
+#define SEMIHOST_SYS_CLOSE 0x02
+#define SEMIHOST_SYS_READ 0x06
+#define SEMIHOST_SYS_FLEN 0x0C
+#define SEMIHOST_MODE_RB 1 // fopen "rb"
+
+// One tensor of the weight blob
+typedef struct
+{
+    void *data;
+    uint32_t size; // bytes
+} dataset_tensor_t;
+
+// The trap is the uncompressed slli/ebreak/srai triple; it must not straddle a
+// page, hence the alignment
+static long semihost_call(long op, const long *args)
+{
+    register long a0 __asm__("a0") = op;
+    register const long *a1 __asm__("a1") = args;
+    __asm__ volatile(".option push\n"
+                     ".option norvc\n"
+                     ".balign 16\n"
+                     "slli x0, x0, 0x1f\n"
+                     "ebreak\n"
+                     "srai x0, x0, 7\n"
+                     ".option pop\n"
+                     : "+r"(a0)
+                     : "r"(a1)
+                     : "memory");
+    return a0;
+}
+
+static long dataset_strlen(const char *s)
+{
+    long n = 0;
+    while (s[n])
+    {
+        n++;
+    }
+    return n;
+}
+
+// Returns the host handle (size in *len) or -1
+static long dataset_open(const char *path, long *len)
+{
+    long args[3] = {(long)path, SEMIHOST_MODE_RB, dataset_strlen(path)};
+    long fd = semihost_call(SEMIHOST_SYS_OPEN, args);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    args[0] = fd;
+    *len = semihost_call(SEMIHOST_SYS_FLEN, args);
+    return *len < 0 ? -1 : fd;
+}
+
+// 0 once all n bytes are read
+static int dataset_read(long fd, void *buf, long n)
+{
+    long args[3] = {fd, (long)buf, n};
+    return semihost_call(SEMIHOST_SYS_READ, args) == 0 ? 0 : -1;
+}
+
+static void dataset_close(long fd)
+{
+    long args[1] = {fd};
+    semihost_call(SEMIHOST_SYS_CLOSE, args);
+}
+
+static void dataset_fail(const char *name, const char *path)
+{
+    platform_puts("dataset,");
+    platform_puts(name);
+    platform_puts(",file=");
+    platform_puts(path);
+    platform_field("status", DATASET_ERR_IO);
+    platform_putc('\n');
+    platform_exit(DATASET_ERR_IO);
+}
+
+// Fills the tensors from DATASET_WEIGHTS; the blob must match the table exactly.
+// Call before any repacking of the weights.
+static void dataset_load_weights(const char *name, const dataset_tensor_t *t, int n)
+{
+    long len, fd = dataset_open(DATASET_WEIGHTS, &len);
+    long total = 0;
+
+    for (int i = 0; i < n; i++)
+    {
+        total += t[i].size;
+    }
+    if (fd < 0 || len != total)
+    {
+        dataset_fail(name, DATASET_WEIGHTS);
+    }
+    for (int i = 0; i < n; i++)
+    {
+        if (dataset_read(fd, t[i].data, t[i].size))
+        {
+            dataset_fail(name, DATASET_WEIGHTS);
+        }
+    }
+    dataset_close(fd);
+}
+
+// Index of the largest logit, first one on ties
+static int dataset_argmax(const int8_t *logits, int n)
+{
+    int best = 0;
+    for (int i = 1; i < n; i++)
+    {
+        if (logits[i] > logits[best])
+        {
+            best = i;
+        }
+    }
+    return best;
+}
+
+// Classifies every frame: set_input(frame) loads one planar uint8 frame into
+// the variant's input buffers, infer() writes the logits. Prints the report and exits.
+static void dataset_run(const char *name, void (*set_input)(const uint8_t *frame), void (*infer)(void),
+                        const int8_t *logits, int num_classes)
+{
+    static uint8_t frames[DATASET_BATCH][DATASET_FRAME];
+    static uint8_t labels[DATASET_BATCH];
+    long img_len, lbl_len, img_fd, lbl_fd;
+    uint64_t cyc = 0, mtime = 0, io_mtime = 0, m0, c0;
+    uint32_t images, correct = 0;
+    int batch;
+
+    m0 = read_mtime64();
+    img_fd = dataset_open(DATASET_IMAGES, &img_len);
+    if (img_fd < 0 || img_len == 0 || img_len % DATASET_FRAME)
+    {
+        dataset_fail(name, DATASET_IMAGES);
+    }
+    images = (uint32_t)(img_len / DATASET_FRAME);
+    lbl_fd = dataset_open(DATASET_LABELS, &lbl_len);
+    if (lbl_fd < 0 || lbl_len < (long)images)
+    {
+        dataset_fail(name, DATASET_LABELS);
+    }
+    if (DATASET_MAX && images > DATASET_MAX)
+    {
+        images = DATASET_MAX;
+    }
+    io_mtime += read_mtime64() - m0;
+
+    for (uint32_t done = 0; done < images; done += batch)
+    {
+        batch = images - done < DATASET_BATCH ? (int)(images - done) : DATASET_BATCH;
+        m0 = read_mtime64();
+        if (dataset_read(img_fd, frames, (long)batch * DATASET_FRAME))
+        {
+            dataset_fail(name, DATASET_IMAGES);
+        }
+        if (dataset_read(lbl_fd, labels, batch))
+        {
+            dataset_fail(name, DATASET_LABELS);
+        }
+        io_mtime += read_mtime64() - m0;
+
+        for (int i = 0; i < batch; i++)
+        {
+            set_input(frames[i]);
+            m0 = read_mtime64();
+            c0 = read_mcycle64();
+            infer();
+            cyc += read_mcycle64() - c0;
+            mtime += read_mtime64() - m0;
+            correct += dataset_argmax(logits, num_classes) == labels[i];
+        }
+    }
+    dataset_close(img_fd);
+    dataset_close(lbl_fd);
+
+    platform_puts("dataset,");
+    platform_puts(name);
+    platform_field("images", images);
+    platform_field("correct", correct);
+    platform_puts(",acc=");
+    platform_putfix((uint64_t)correct * 10000u / images, 2);
+    platform_field("cyc_avg", cyc / images);
+    platform_field("mtime", mtime);
+    platform_field("io_mtime", io_mtime);
+    platform_rate("inf_s", images, mtime);
+    platform_field("status", DATASET_OK);
+    platform_putc('\n');
+#ifdef DATASET_REPORT
+    DATASET_REPORT(name); // variant's own report on the last frame and weights (e.g. sparse.h)
+#endif
+
+    platform_exit(DATASET_OK);
+}
+
+#endif // RESNET8_DATASET_H
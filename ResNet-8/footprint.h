@@ -0,0 +1,58 @@
+// Memory footprint report for the bare-metal variants.
+// crt0.s paints the whole stack with FOOTPRINT_PAINT before calling main; the
+// deepest word that no longer holds the pattern is the stack high-water mark.
+// Build a variant with -DFOOTPRINT and, after its timed inference, main prints
+//
+//   mem,<name>,stack_hwm=..,stack_size=..,text=..,rodata=..,data=..,bss=..,ram=..,flash=..
+//
+// (bytes; ram = data + bss + stack_hwm, flash = text + rodata + data) and powers
+// the machine off through the virt test finisher. The section sizes come from
+// the link.ld boundary symbols; Tools/footprint.py adds the per-symbol view.
+#ifndef RESNET8_FOOTPRINT_H
+#define RESNET8_FOOTPRINT_H
+
+#include <stdint.h>
+
+#include "platform.h"
+
+#define FOOTPRINT_PAINT 0x5a5a5a5au // must match crt0.s
+
+extern char _text_start[], _text_end[], _rodata_start[], _rodata_end[];
+extern char _data_start[], _data_end[], _bss_start[], _bss_end[];
+extern char _stack_start[], _stack_top[];
+
+// Deepest stack use since reset: scan up from the bottom for the first overwritten word
+static uint32_t footprint_stack_hwm(void)
+{
+    const volatile uint32_t *p = (const volatile uint32_t *)_stack_start;
+    while (p < (const volatile uint32_t *)_stack_top && *p == FOOTPRINT_PAINT)
+    {
+        p++;
+    }
+    return (uint32_t)(_stack_top - (const char *)p);
+}
+
+static void footprint_report(const char *name)
+{
+    uint32_t hwm = footprint_stack_hwm();
+    uint32_t text = (uint32_t)(_text_end - _text_start);
+    uint32_t rodata = (uint32_t)(_rodata_end - _rodata_start);
+    uint32_t data = (uint32_t)(_data_end - _data_start);
+    uint32_t bss = (uint32_t)(_bss_end - _bss_start);
+
+    platform_puts("mem,");
+    platform_puts(name);
+    platform_field("stack_hwm", hwm);
+    platform_field("stack_size", (uint64_t)(_stack_top - _stack_start));
+    platform_field("text", text);
+    platform_field("rodata", rodata);
+    platform_field("data", data);
+    platform_field("bss", bss);
+    platform_field("ram", (uint64_t)data + bss + hwm);
+    platform_field("flash", (uint64_t)text + rodata + data);
+    platform_putc('\n');
+
+    platform_exit(0);
+}
+
+#endif // RESNET8_FOOTPRINT_H
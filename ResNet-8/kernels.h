@@ -0,0 +1,1488 @@
+// INT8 kernel library for the ResNet-8 variants.
+// A layer is described by its shape (in_c, in_h, in_w, out_c, k, stride, pad) and
+// an epilogue. The DEFINE_* macros instantiate one kernel per concrete layer, so
+// every dimension is a compile-time constant: index arithmetic folds, and the
+// kh/kw loops are fully unrolled as in the hand-written fixed-size loops.
+//
+//   #define RB_CONV_SHAPE 32, 32, 32, 32, 3, 1, 1
+//   DEFINE_CONV2D(conv2d_qrelu_32in, RB_CONV_SHAPE, relu)
+//
+// defines  static void conv2d_qrelu_32in(in, out, w, b)
+// and      static const layer_desc_t conv2d_qrelu_32in_desc.
+#ifndef RESNET8_KERNELS_H
+#define RESNET8_KERNELS_H
+
+#include <stdint.h>
+
+#ifndef QSHIFT
+#define QSHIFT 8
+#endif
+
+#define KERNELS_PRAGMA(x) _Pragma(#x)
+#define KERNELS_UNROLL(n) KERNELS_PRAGMA(GCC unroll n)
+
+// Output size of a convolution along one spatial dimension
+#define CONV_OUT_DIM(in, k, stride, pad) (((in) + 2 * (pad) - (k)) / (stride) + 1)
+// Asymmetric padding: pad_lo rows/cols before the input, pad_hi after
+#define CONV_OUT_DIM_PAD(in, k, stride, pad_lo, pad_hi) (((in) + (pad_lo) + (pad_hi) - (k)) / (stride) + 1)
+
+typedef enum
+{
+    EPI_RELU,      // requantize, saturate to [0,127]
+    EPI_QUANT_CLIP // requantize, saturate to [-128,127]
+} epilogue_t;
+
+// Runtime view of an instantiated layer (shape checks, reports, dispatch tables)
+typedef struct
+{
+    const char *name;
+    int in_c, in_h, in_w;
+    int out_c, out_h, out_w;
+    int k, stride, pad; // pad: leading (top/left) padding
+    epilogue_t epilogue;
+} layer_desc_t;
+
+// Epilogues: requantize (>> shift) and saturate
+static inline int8_t relu_shift(int32_t acc, int shift)
+{
+    int32_t q = acc >> shift;
+    if (q < 0)
+    {
+        q = 0;
+    }
+    else if (q > 127)
+    {
+        q = 127;
+    }
+
+    return (int8_t)q;
+}
+static inline int8_t quant_clip_shift(int32_t acc, int shift)
+{
+    int32_t q = acc >> shift;
+    if (q < -128)
+    {
+        q = -128;
+    }
+    else if (q > 127)
+    {
+        q = 127;
+    }
+
+    return (int8_t)q;
+}
+static inline int8_t relu(int32_t acc) { return relu_shift(acc, QSHIFT); }
+static inline int8_t quant_clip(int32_t acc) { return quant_clip_shift(acc, QSHIFT); }
+
+// Every epilogue usable as DEFINE_* argument has a matching <name>_EPI enumerator
+enum
+{
+    relu_EPI = EPI_RELU,
+    quant_clip_EPI = EPI_QUANT_CLIP
+};
+
+// Epilogues for layers whose requantization shift differs from QSHIFT:
+// DEFINE_EPILOGUES(s7, 7) defines relu_s7() and quant_clip_s7()
+#define DEFINE_EPILOGUES(suffix, shift)                                                            \
+    static inline int8_t relu_##suffix(int32_t acc) { return relu_shift(acc, shift); }             \
+    static inline int8_t quant_clip_##suffix(int32_t acc) { return quant_clip_shift(acc, shift); } \
+    enum                                                                                           \
+    {                                                                                              \
+        relu_##suffix##_EPI = EPI_RELU,                                                            \
+        quant_clip_##suffix##_EPI = EPI_QUANT_CLIP                                                 \
+    };
+
+// Interior/border split. Output rows/cols in [CONV_IN_LO, CONV_IN_HI) see a
+// KSxKS window entirely inside the input: the kernels below run them with
+// constant tap ranges (fully unrolled, no padding test) and only the outer ring
+// gets its kh/kw range trimmed, once per output instead of a test per MAC.
+#define CONV_IN_LO(S, P) (((P) + (S) - 1) / (S))
+#define CONV_IN_HI_(in, k, S, P) ((in) + (P) >= (k) ? ((in) + (P) - (k)) / (S) + 1 : 0)
+#define CONV_IN_HI(in, k, S, P) (CONV_IN_HI_(in, k, S, P) > CONV_IN_LO(S, P) ? CONV_IN_HI_(in, k, S, P) : CONV_IN_LO(S, P))
+// First and one-past-last valid tap of a window starting at input index i0
+#define CONV_TAP_LO(i0) ((i0) < 0 ? -(i0) : 0)
+#define CONV_TAP_HI(i0, in, k) ((i0) + (k) > (in) ? (in) - (i0) : (k))
+#define KERNELS_INLINE static inline __attribute__((always_inline))
+
+// Convolution (CHW activations, OIHW weights, int32 bias) with fused epilogue
+#define DEFINE_CONV2D(name, ...) DEFINE_CONV2D_(name, __VA_ARGS__)
+#define DEFINE_CONV2D_(name, IC, IH, IW, OC, KS, S, P, EPI) DEFINE_CONV2D_PAD_(name, IC, IH, IW, OC, KS, S, P, P, EPI)
+// Same with PLO rows/cols of zero padding before the input and PHI after, e.g.
+// TF/Keras padding='same' for a stride-2 3x3 conv on an even input (PLO 0, PHI 1)
+#define DEFINE_CONV2D_PAD(name, ...) DEFINE_CONV2D_PAD_(name, __VA_ARGS__)
+#define DEFINE_CONV2D_PAD_(name, IC, IH, IW, OC, KS, S, PLO, PHI, EPI)                                               \
+    enum                                                                                                             \
+    {                                                                                                                \
+        name##_OH = CONV_OUT_DIM_PAD(IH, KS, S, PLO, PHI),                                                           \
+        name##_OW = CONV_OUT_DIM_PAD(IW, KS, S, PLO, PHI)                                                            \
+    };                                                                                                               \
+    __attribute__((unused)) static const layer_desc_t name##_desc = {                                                \
+        #name, IC, IH, IW, OC, name##_OH, name##_OW, KS, S, PLO, (epilogue_t)EPI##_EPI};                             \
+    /* Taps [kh0, kh1) x [kw0, kw1) of the window at (ih0, iw0) */                                                   \
+    KERNELS_INLINE int32_t name##_window(const int8_t in[IC][IH][IW], const int8_t w[IC][KS][KS],                    \
+                                         int ih0, int iw0, int kh0, int kh1, int kw0, int kw1)                       \
+    {                                                                                                                \
+        int32_t acc = 0;                                                                                             \
+        for (int ic = 0; ic < IC; ic++)                                                                              \
+        {                                                                                                            \
+            KERNELS_UNROLL(KS)                                                                                       \
+            for (int kh = kh0; kh < kh1; kh++)                                                                       \
+            {                                                                                                        \
+                KERNELS_UNROLL(KS)                                                                                   \
+                for (int kw = kw0; kw < kw1; kw++)                                                                   \
+                {                                                                                                    \
+                    acc += (int32_t)in[ic][ih0 + kh][iw0 + kw] * (int32_t)w[ic][kh][kw];                             \
+                }                                                                                                    \
+            }                                                                                                        \
+        }                                                                                                            \
+        return acc;                                                                                                  \
+    }                                                                                                                \
+    /* One output row: left edge, branch-free interior, right edge */                                                \
+    KERNELS_INLINE void name##_row(const int8_t in[IC][IH][IW], int8_t out[name##_OW],                               \
+                                   const int8_t w[IC][KS][KS], int32_t b, int ih0, int kh0, int kh1)                 \
+    {                                                                                                                \
+        int ow = 0, iw0;                                                                                             \
+        for (; ow < CONV_IN_LO(S, PLO) && ow < name##_OW; ow++)                                                      \
+        {                                                                                                            \
+            iw0 = ow * S - PLO;                                                                                      \
+            out[ow] = EPI(b + name##_window(in, w, ih0, iw0, kh0, kh1, CONV_TAP_LO(iw0), CONV_TAP_HI(iw0, IW, KS))); \
+        }                                                                                                            \
+        for (; ow < CONV_IN_HI(IW, KS, S, PLO); ow++)                                                                \
+        {                                                                                                            \
+            out[ow] = EPI(b + name##_window(in, w, ih0, ow * S - PLO, kh0, kh1, 0, KS));                             \
+        }                                                                                                            \
+        for (; ow < name##_OW; ow++)                                                                                 \
+        {                                                                                                            \
+            iw0 = ow * S - PLO;                                                                                      \
+            out[ow] = EPI(b + name##_window(in, w, ih0, iw0, kh0, kh1, CONV_TAP_LO(iw0), CONV_TAP_HI(iw0, IW, KS))); \
+        }                                                                                                            \
+    }                                                                                                                \
+    static void name(const int8_t in[IC][IH][IW], int8_t out[OC][name##_OH][name##_OW],                              \
+                     const int8_t w[OC][IC][KS][KS], const int32_t b[OC])                                            \
+    {                                                                                                                \
+        int ih0;                                                                                                     \
+        for (int oc = 0; oc < OC; oc++)                                                                              \
+        {                                                                                                            \
+            for (int oh = 0; oh < name##_OH; oh++)                                                                   \
+            {                                                                                                        \
+                ih0 = oh * S - PLO;                                                                                  \
+                if (oh >= CONV_IN_LO(S, PLO) && oh < CONV_IN_HI(IH, KS, S, PLO))                                     \
+                {                                                                                                    \
+                    name##_row(in, out[oc][oh], w[oc], b[oc], ih0, 0, KS);                                           \
+                }                                                                                                    \
+                else                                                                                                 \
+                {                                                                                                    \
+                    name##_row(in, out[oc][oh], w[oc], b[oc], ih0, CONV_TAP_LO(ih0), CONV_TAP_HI(ih0, IH, KS));      \
+                }                                                                                                    \
+            }                                                                                                        \
+        }                                                                                                            \
+    }
+
+// First convolution fed straight from uint8 interleaved frames (HWC), input
+// zero point ZP: sum w*(x - ZP) = sum w*x - ZP*sum w, so the correction lives in
+// the bias (DEFINE_FOLD_INPUT_ZP, computed once at weight-load time). Padding
+// taps read ZP (= 0 after the zero-point shift) to keep the border exact.
+#define DEFINE_CONV2D_U8HWC(name, ...) DEFINE_CONV2D_U8HWC_(name, __VA_ARGS__)
+#define DEFINE_CONV2D_U8HWC_(name, IC, IH, IW, OC, KS, S, P, EPI, ZP)                                                       \
+    __attribute__((unused)) static const layer_desc_t name##_desc = {                                                       \
+        #name, IC, IH, IW, OC, CONV_OUT_DIM(IH, KS, S, P), CONV_OUT_DIM(IW, KS, S, P), KS, S, P, (epilogue_t)EPI##_EPI};    \
+    static void name(const uint8_t in[IH][IW][IC], int8_t out[OC][CONV_OUT_DIM(IH, KS, S, P)][CONV_OUT_DIM(IW, KS, S, P)],  \
+                     const int8_t w[OC][IC][KS][KS], const int32_t b_zp[OC])                                                \
+    {                                                                                                                       \
+        int32_t acc, x;                                                                                                     \
+        int ih, iw;                                                                                                         \
+        for (int oc = 0; oc < OC; oc++)                                                                                     \
+        {                                                                                                                   \
+            for (int oh = 0; oh < CONV_OUT_DIM(IH, KS, S, P); oh++)                                                         \
+            {                                                                                                               \
+                for (int ow = 0; ow < CONV_OUT_DIM(IW, KS, S, P); ow++)                                                     \
+                {                                                                                                           \
+                    acc = b_zp[oc];                                                                                         \
+                    KERNELS_UNROLL(KS)                                                                                      \
+                    for (int kh = 0; kh < KS; kh++)                                                                         \
+                    {                                                                                                       \
+                        ih = oh * S + kh - P;                                                                               \
+                        KERNELS_UNROLL(KS)                                                                                  \
+                        for (int kw = 0; kw < KS; kw++)                                                                     \
+                        {                                                                                                   \
+                            iw = ow * S + kw - P;                                                                           \
+                            KERNELS_UNROLL(IC)                                                                              \
+                            for (int ic = 0; ic < IC; ic++)                                                                 \
+                            {                                                                                               \
+                                x = ((unsigned)ih < IH && (unsigned)iw < IW) ? (int32_t)in[ih][iw][ic] : (ZP);              \
+                                acc += x * (int32_t)w[oc][ic][kh][kw];                                                      \
+                            }                                                                                               \
+                        }                                                                                                   \
+                    }                                                                                                       \
+                    out[oc][oh][ow] = EPI(acc);                                                                             \
+                }                                                                                                           \
+            }                                                                                                               \
+        }                                                                                                                   \
+    }
+
+// b_zp[oc] = b[oc] - zp * sum(w[oc]): bias for the uint8-input convolutions
+#define DEFINE_FOLD_INPUT_ZP(name, OC, IC, KS)                                                          \
+    static void name(const int8_t w[OC][IC][KS][KS], const int32_t b[OC], int32_t zp, int32_t b_zp[OC]) \
+    {                                                                                                   \
+        int32_t sum;                                                                                    \
+        for (int oc = 0; oc < OC; oc++)                                                                 \
+        {                                                                                               \
+            sum = 0;                                                                                    \
+            for (int ic = 0; ic < IC; ic++)                                                             \
+            {                                                                                           \
+                for (int kh = 0; kh < KS; kh++)                                                         \
+                {                                                                                       \
+                    for (int kw = 0; kw < KS; kw++)                                                     \
+                    {                                                                                   \
+                        sum += w[oc][ic][kh][kw];                                                       \
+                    }                                                                                   \
+                }                                                                                       \
+            }                                                                                           \
+            b_zp[oc] = b[oc] - zp * sum;                                                                \
+        }                                                                                               \
+    }
+
+// Residual skip add: out = clamp(a + b, 0, 127)
+#define DEFINE_SKIP_ADD_RELU(name, C, H, W)                                                 \
+    static void name(const int8_t a[C][H][W], const int8_t b[C][H][W], int8_t out[C][H][W]) \
+    {                                                                                       \
+        int32_t s;                                                                          \
+        for (int c = 0; c < C; c++)                                                         \
+        {                                                                                   \
+            for (int h = 0; h < H; h++)                                                     \
+            {                                                                               \
+                for (int w = 0; w < W; w++)                                                 \
+                {                                                                           \
+                    s = (int32_t)a[c][h][w] + (int32_t)b[c][h][w];                          \
+                    if (s < 0)                                                              \
+                    {                                                                       \
+                        s = 0;                                                              \
+                    }                                                                       \
+                    else if (s > 127)                                                       \
+                    {                                                                       \
+                        s = 127;                                                            \
+                    }                                                                       \
+                    out[c][h][w] = (int8_t)s;                                               \
+                }                                                                           \
+            }                                                                               \
+        }                                                                                   \
+    }
+
+// Global average pooling, H*W == 1 << SHIFT
+#define DEFINE_GLOBAL_AVG_POOL(name, C, H, W, SHIFT)                                        \
+    _Static_assert((H) * (W) == 1 << (SHIFT), #name ": H*W must be 1 << SHIFT");            \
+    static void name(const int8_t in[C][H][W], int8_t out_vec[C])                           \
+    {                                                                                       \
+        int32_t acc, m;                                                                     \
+        for (int c = 0; c < C; c++)                                                         \
+        {                                                                                   \
+            acc = 0;                                                                        \
+            for (int h = 0; h < H; h++)                                                     \
+            {                                                                               \
+                for (int w = 0; w < W; w++)                                                 \
+                {                                                                           \
+                    acc += (int32_t)in[c][h][w];                                            \
+                }                                                                           \
+            }                                                                               \
+            m = acc >> (SHIFT);                                                             \
+            if (m < -128)                                                                   \
+            {                                                                               \
+                m = -128;                                                                   \
+            }                                                                               \
+            else if (m > 127)                                                               \
+            {                                                                               \
+                m = 127;                                                                    \
+            }                                                                               \
+            out_vec[c] = (int8_t)m;                                                         \
+        }                                                                                   \
+    }
+
+// Fully connected layer with fused epilogue
+#define DEFINE_FC(name, IN, OUT, EPI)                                                                             \
+    static void name(const int8_t in_vec[IN], int8_t out_vec[OUT], const int8_t w[OUT][IN], const int32_t b[OUT]) \
+    {                                                                                                             \
+        int32_t acc;                                                                                              \
+        for (int c = 0; c < OUT; c++)                                                                             \
+        {                                                                                                         \
+            acc = b[c];                                                                                           \
+            for (int k = 0; k < IN; k++)                                                                          \
+            {                                                                                                     \
+                acc += (int32_t)in_vec[k] * (int32_t)w[c][k];                                                     \
+            }                                                                                                     \
+            out_vec[c] = EPI(acc);                                                                                \
+        }                                                                                                         \
+    }
+
+// ---- Dirty-region (delta) variants ----
+// Incremental inference on a stream of similar frames: the outputs whose window
+// reads no changed input keep their value from the previous call, only the
+// dirty region is recomputed. A region is a rectangle of spatial positions
+// shared by all channels (CHW activations, OIHW weights).
+typedef struct
+{
+    int h0, h1, w0, w1; // rows [h0, h1) x cols [w0, w1), empty if h0 >= h1
+} region_t;
+
+static const region_t region_none = {0, 0, 0, 0};
+
+static inline int region_empty(const region_t *r) { return r->h0 >= r->h1 || r->w0 >= r->w1; }
+static inline int region_area(const region_t *r) { return region_empty(r) ? 0 : (r->h1 - r->h0) * (r->w1 - r->w0); }
+
+// First / one-past-last output of a KS/S/P conv (out outputs) reading inputs [i0, i1)
+static inline int region_lo(int i0, int ks, int s, int p) { return i0 + p - ks + 1 <= 0 ? 0 : (i0 + p - ks + s) / s; }
+static inline int region_hi(int i1, int out, int s, int p) { return (i1 - 1 + p) / s + 1 > out ? out : (i1 - 1 + p) / s + 1; }
+
+// Output region of a convolution whose windows touch the input region r:
+// grows by one position per side through a 3x3/1/1 layer
+static inline region_t region_conv(const region_t *r, int out_h, int out_w, int ks, int s, int p)
+{
+    region_t o;
+    if (region_empty(r))
+    {
+        return region_none;
+    }
+    o.h0 = region_lo(r->h0, ks, s, p);
+    o.h1 = region_hi(r->h1, out_h, s, p);
+    o.w0 = region_lo(r->w0, ks, s, p);
+    o.w1 = region_hi(r->w1, out_w, s, p);
+    return region_empty(&o) ? region_none : o;
+}
+
+// Convolution restricted to the output region r (the rest of out is untouched)
+#define DEFINE_CONV2D_REGION(name, ...) DEFINE_CONV2D_REGION_(name, __VA_ARGS__)
+#define DEFINE_CONV2D_REGION_(name, IC, IH, IW, OC, KS, S, P, EPI)                                                             \
+    KERNELS_INLINE int32_t name##_window(const int8_t in[IC][IH][IW], const int8_t w[IC][KS][KS],                              \
+                                         int ih0, int iw0, int kh0, int kh1, int kw0, int kw1)                                 \
+    {                                                                                                                          \
+        int32_t acc = 0;                                                                                                       \
+        for (int ic = 0; ic < IC; ic++)                                                                                        \
+        {                                                                                                                      \
+            KERNELS_UNROLL(KS)                                                                                                 \
+            for (int kh = kh0; kh < kh1; kh++)                                                                                 \
+            {                                                                                                                  \
+                KERNELS_UNROLL(KS)                                                                                             \
+                for (int kw = kw0; kw < kw1; kw++)                                                                             \
+                {                                                                                                              \
+                    acc += (int32_t)in[ic][ih0 + kh][iw0 + kw] * (int32_t)w[ic][kh][kw];                                       \
+                }                                                                                                              \
+            }                                                                                                                  \
+        }                                                                                                                      \
+        return acc;                                                                                                            \
+    }                                                                                                                          \
+    /* Columns [ow0, ow1) of one output row, split as in DEFINE_CONV2D */                                                      \
+    KERNELS_INLINE void name##_span(const int8_t in[IC][IH][IW], int8_t out[CONV_OUT_DIM(IW, KS, S, P)],                       \
+                                    const int8_t w[IC][KS][KS], int32_t b, int ih0, int kh0, int kh1, int ow0, int ow1)        \
+    {                                                                                                                          \
+        int ow = ow0, iw0;                                                                                                     \
+        for (; ow < ow1 && ow < CONV_IN_LO(S, P); ow++)                                                                        \
+        {                                                                                                                      \
+            iw0 = ow * S - P;                                                                                                  \
+            out[ow] = EPI(b + name##_window(in, w, ih0, iw0, kh0, kh1, CONV_TAP_LO(iw0), CONV_TAP_HI(iw0, IW, KS)));           \
+        }                                                                                                                      \
+        for (; ow < ow1 && ow < CONV_IN_HI(IW, KS, S, P); ow++)                                                                \
+        {                                                                                                                      \
+            out[ow] = EPI(b + name##_window(in, w, ih0, ow * S - P, kh0, kh1, 0, KS));                                         \
+        }                                                                                                                      \
+        for (; ow < ow1; ow++)                                                                                                 \
+        {                                                                                                                      \
+            iw0 = ow * S - P;                                                                                                  \
+            out[ow] = EPI(b + name##_window(in, w, ih0, iw0, kh0, kh1, CONV_TAP_LO(iw0), CONV_TAP_HI(iw0, IW, KS)));           \
+        }                                                                                                                      \
+    }                                                                                                                          \
+    static void name(const int8_t in[IC][IH][IW], int8_t out[OC][CONV_OUT_DIM(IH, KS, S, P)][CONV_OUT_DIM(IW, KS, S, P)],      \
+                     const int8_t w[OC][IC][KS][KS], const int32_t b[OC], const region_t *r)                                   \
+    {                                                                                                                          \
+        int ih0;                                                                                                               \
+        for (int oc = 0; oc < OC; oc++)                                                                                        \
+        {                                                                                                                      \
+            for (int oh = r->h0; oh < r->h1; oh++)                                                                             \
+            {                                                                                                                  \
+                ih0 = oh * S - P;                                                                                              \
+                if (oh >= CONV_IN_LO(S, P) && oh < CONV_IN_HI(IH, KS, S, P))                                                   \
+                {                                                                                                              \
+                    name##_span(in, out[oc][oh], w[oc], b[oc], ih0, 0, KS, r->w0, r->w1);                                      \
+                }                                                                                                              \
+                else                                                                                                           \
+                {                                                                                                              \
+                    name##_span(in, out[oc][oh], w[oc], b[oc], ih0, CONV_TAP_LO(ih0), CONV_TAP_HI(ih0, IH, KS), r->w0, r->w1); \
+                }                                                                                                              \
+            }                                                                                                                  \
+        }                                                                                                                      \
+    }
+
+// Bounding box of the positions where in differs from prev (any channel);
+// prev is updated to in
+#define DEFINE_DIFF_REGION(name, C, H, W)                                \
+    static region_t name(const int8_t in[C][H][W], int8_t prev[C][H][W]) \
+    {                                                                    \
+        region_t r = {H, 0, W, 0};                                       \
+        for (int c = 0; c < C; c++)                                      \
+        {                                                                \
+            for (int h = 0; h < H; h++)                                  \
+            {                                                            \
+                for (int w = 0; w < W; w++)                              \
+                {                                                        \
+                    if (in[c][h][w] != prev[c][h][w])                    \
+                    {                                                    \
+                        prev[c][h][w] = in[c][h][w];                     \
+                        r.h0 = h < r.h0 ? h : r.h0;                      \
+                        r.h1 = h + 1 > r.h1 ? h + 1 : r.h1;              \
+                        r.w0 = w < r.w0 ? w : r.w0;                      \
+                        r.w1 = w + 1 > r.w1 ? w + 1 : r.w1;              \
+                    }                                                    \
+                }                                                        \
+            }                                                            \
+        }                                                                \
+        return r;                                                        \
+    }
+
+// Residual skip add on the region r only
+#define DEFINE_SKIP_ADD_RELU_REGION(name, C, H, W)                                                             \
+    static void name(const int8_t a[C][H][W], const int8_t b[C][H][W], int8_t out[C][H][W], const region_t *r) \
+    {                                                                                                          \
+        int32_t s;                                                                                             \
+        for (int c = 0; c < C; c++)                                                                            \
+        {                                                                                                      \
+            for (int h = r->h0; h < r->h1; h++)                                                                \
+            {                                                                                                  \
+                for (int w = r->w0; w < r->w1; w++)                                                            \
+                {                                                                                              \
+                    s = (int32_t)a[c][h][w] + (int32_t)b[c][h][w];                                             \
+                    out[c][h][w] = (int8_t)(s < 0 ? 0 : s > 127 ? 127 : s);                                    \
+                }                                                                                              \
+            }                                                                                                  \
+        }                                                                                                      \
+    }
+
+// Global average pooling from running per-channel sums: name##_acc(in, sums,
+// r, -1) before and (.., +1) after rewriting the region r of in keeps the sums
+// exact; name(sums, out) requantizes like DEFINE_GLOBAL_AVG_POOL
+#define DEFINE_GLOBAL_AVG_POOL_DELTA(name, C, H, W, SHIFT)                                             \
+    _Static_assert((H) * (W) == 1 << (SHIFT), #name ": H*W must be 1 << SHIFT");                       \
+    static void name##_acc(const int8_t in[C][H][W], int32_t sums[C], const region_t *r, int32_t sign) \
+    {                                                                                                  \
+        int32_t acc;                                                                                   \
+        for (int c = 0; c < C; c++)                                                                    \
+        {                                                                                              \
+            acc = 0;                                                                                   \
+            for (int h = r->h0; h < r->h1; h++)                                                        \
+            {                                                                                          \
+                for (int w = r->w0; w < r->w1; w++)                                                    \
+                {                                                                                      \
+                    acc += (int32_t)in[c][h][w];                                                       \
+                }                                                                                      \
+            }                                                                                          \
+            sums[c] += sign * acc;                                                                     \
+        }                                                                                              \
+    }                                                                                                  \
+    static void name(const int32_t sums[C], int8_t out_vec[C])                                         \
+    {                                                                                                  \
+        int32_t m;                                                                                     \
+        for (int c = 0; c < C; c++)                                                                    \
+        {                                                                                              \
+            m = sums[c] >> (SHIFT);                                                                    \
+            out_vec[c] = (int8_t)(m < -128 ? -128 : m > 127 ? 127 : m);                                \
+        }                                                                                              \
+    }
+
+// ---- Channel-last (NHWC) variants ----
+// Activations [h][w][c], conv weights OHWI [oc][kh][kw][ic]: the reduction of a
+// tap runs over IC contiguous bytes of both the input pixel and the weights
+// (word loads, SWAR, vectors), instead of striding H*W bytes per channel as in
+// CHW. The FC layer is layout-independent (GAP output is a plain vector).
+#define DEFINE_CONV2D_NHWC(name, ...) DEFINE_CONV2D_NHWC_(name, __VA_ARGS__)
+#define DEFINE_CONV2D_NHWC_(name, IC, IH, IW, OC, KS, S, P, EPI) DEFINE_CONV2D_NHWC_T_(name, int8_t, 0, IC, IH, IW, OC, KS, S, P, EPI)
+// uint8 HWC frames in, zero point ZP folded into the bias (DEFINE_FOLD_INPUT_ZP)
+#define DEFINE_CONV2D_U8_NHWC(name, ...) DEFINE_CONV2D_U8_NHWC_(name, __VA_ARGS__)
+#define DEFINE_CONV2D_U8_NHWC_(name, IC, IH, IW, OC, KS, S, P, EPI, ZP) DEFINE_CONV2D_NHWC_T_(name, uint8_t, ZP, IC, IH, IW, OC, KS, S, P, EPI)
+#define DEFINE_CONV2D_NHWC_T_(name, T, PADV, IC, IH, IW, OC, KS, S, P, EPI)                                              \
+    __attribute__((unused)) static const layer_desc_t name##_desc = {                                                    \
+        #name, IC, IH, IW, OC, CONV_OUT_DIM(IH, KS, S, P), CONV_OUT_DIM(IW, KS, S, P), KS, S, P, (epilogue_t)EPI##_EPI}; \
+    static void name(const T in[IH][IW][IC], int8_t out[CONV_OUT_DIM(IH, KS, S, P)][CONV_OUT_DIM(IW, KS, S, P)][OC],     \
+                     const int8_t w[OC][KS][KS][IC], const int32_t b[OC])                                                \
+    {                                                                                                                    \
+        int32_t acc;                                                                                                     \
+        int ih, iw;                                                                                                      \
+        for (int oh = 0; oh < CONV_OUT_DIM(IH, KS, S, P); oh++)                                                          \
+        {                                                                                                                \
+            for (int ow = 0; ow < CONV_OUT_DIM(IW, KS, S, P); ow++)                                                      \
+            {                                                                                                            \
+                for (int oc = 0; oc < OC; oc++)                                                                          \
+                {                                                                                                        \
+                    acc = b[oc];                                                                                         \
+                    KERNELS_UNROLL(KS)                                                                                   \
+                    for (int kh = 0; kh < KS; kh++)                                                                      \
+                    {                                                                                                    \
+                        ih = oh * S + kh - P;                                                                            \
+                        KERNELS_UNROLL(KS)                                                                               \
+                        for (int kw = 0; kw < KS; kw++)                                                                  \
+                        {                                                                                                \
+                            iw = ow * S + kw - P;                                                                        \
+                            if ((unsigned)ih < IH && (unsigned)iw < IW)                                                  \
+                            {                                                                                            \
+                                const T *x = in[ih][iw];                                                                 \
+                                const int8_t *wk = w[oc][kh][kw];                                                        \
+                                KERNELS_UNROLL(8)                                                                        \
+                                for (int ic = 0; ic < IC; ic++)                                                          \
+                                {                                                                                        \
+                                    acc += (int32_t)x[ic] * (int32_t)wk[ic];                                             \
+                                }                                                                                        \
+                            }                                                                                            \
+                            else if ((PADV) != 0)                                                                        \
+                            {                                                                                            \
+                                for (int ic = 0; ic < IC; ic++)                                                          \
+                                {                                                                                        \
+                                    acc += (PADV) * (int32_t)w[oc][kh][kw][ic];                                          \
+                                }                                                                                        \
+                            }                                                                                            \
+                        }                                                                                                \
+                    }                                                                                                    \
+                    out[oh][ow][oc] = EPI(acc);                                                                          \
+                }                                                                                                        \
+            }                                                                                                            \
+        }                                                                                                                \
+    }
+
+// Elementwise, so the CHW kernel over [H][W][C]
+#define DEFINE_SKIP_ADD_RELU_NHWC(name, C, H, W) DEFINE_SKIP_ADD_RELU(name, H, W, C)
+
+// Global average pooling over [H][W][C], one running sum per channel
+#define DEFINE_GLOBAL_AVG_POOL_NHWC(name, C, H, W, SHIFT)                        \
+    _Static_assert((H) * (W) == 1 << (SHIFT), #name ": H*W must be 1 << SHIFT"); \
+    static void name(const int8_t in[H][W][C], int8_t out_vec[C])                \
+    {                                                                            \
+        int32_t acc[C], m;                                                       \
+        for (int c = 0; c < C; c++)                                              \
+        {                                                                        \
+            acc[c] = 0;                                                          \
+        }                                                                        \
+        for (int h = 0; h < H; h++)                                              \
+        {                                                                        \
+            for (int w = 0; w < W; w++)                                          \
+            {                                                                    \
+                for (int c = 0; c < C; c++)                                      \
+                {                                                                \
+                    acc[c] += (int32_t)in[h][w][c];                              \
+                }                                                                \
+            }                                                                    \
+        }                                                                        \
+        for (int c = 0; c < C; c++)                                              \
+        {                                                                        \
+            m = acc[c] >> (SHIFT);                                               \
+            if (m < -128)                                                        \
+            {                                                                    \
+                m = -128;                                                        \
+            }                                                                    \
+            else if (m > 127)                                                    \
+            {                                                                    \
+                m = 127;                                                         \
+            }                                                                    \
+            out_vec[c] = (int8_t)m;                                              \
+        }                                                                        \
+    }
+
+// OIHW -> OHWI weight repacking (weight-load time)
+#define DEFINE_REPACK_OIHW_OHWI(name, OC, IC, KS)                                  \
+    static void name(const int8_t src[OC][IC][KS][KS], int8_t dst[OC][KS][KS][IC]) \
+    {                                                                              \
+        for (int oc = 0; oc < OC; oc++)                                            \
+        {                                                                          \
+            for (int ic = 0; ic < IC; ic++)                                        \
+            {                                                                      \
+                for (int kh = 0; kh < KS; kh++)                                    \
+                {                                                                  \
+                    for (int kw = 0; kw < KS; kw++)                                \
+                    {                                                              \
+                        dst[oc][kh][kw][ic] = src[oc][ic][kh][kw];                 \
+                    }                                                              \
+                }                                                                  \
+            }                                                                      \
+        }                                                                          \
+    }
+
+// ---- Output-channel-blocked weights ----
+// A one-time repacking interleaves OCB output channels per tap:
+//   CHW  kernels: w[OC/OCB][IC][KS][KS][OCB]
+//   NHWC kernels: w[OC/OCB][KS][KS][IC][OCB]  (OHWI, oc-interleaved)
+// so the kernel streams the weights sequentially and every activation byte it
+// loads feeds OCB accumulators (OCB = 4 or 8 fits the integer register file).
+#define DEFINE_CONV2D_OCB(name, ...) DEFINE_CONV2D_OCB_(name, __VA_ARGS__)
+#define DEFINE_CONV2D_OCB_(name, IC, IH, IW, OC, KS, S, P, EPI, OCB)                                                                    \
+    _Static_assert((OC) % (OCB) == 0, #name ": OC must be a multiple of OCB");                                                          \
+    __attribute__((unused)) static const layer_desc_t name##_desc = {                                                                   \
+        #name, IC, IH, IW, OC, CONV_OUT_DIM(IH, KS, S, P), CONV_OUT_DIM(IW, KS, S, P), KS, S, P, (epilogue_t)EPI##_EPI};                \
+    /* OCB outputs of one pixel over taps [kh0, kh1) x [kw0, kw1) */                                                                    \
+    KERNELS_INLINE void name##_px(const int8_t in[IC][IH][IW], int8_t out[OC][CONV_OUT_DIM(IH, KS, S, P)][CONV_OUT_DIM(IW, KS, S, P)],  \
+                                  const int8_t w[IC][KS][KS][OCB], const int32_t b[OCB], int oc0, int oh, int ow,                       \
+                                  int kh0, int kh1, int kw0, int kw1)                                                                   \
+    {                                                                                                                                   \
+        int32_t acc[OCB], x;                                                                                                            \
+        int ih0 = oh * S - P, iw0 = ow * S - P;                                                                                         \
+        KERNELS_UNROLL(OCB)                                                                                                             \
+        for (int j = 0; j < OCB; j++)                                                                                                   \
+        {                                                                                                                               \
+            acc[j] = b[j];                                                                                                              \
+        }                                                                                                                               \
+        for (int ic = 0; ic < IC; ic++)                                                                                                 \
+        {                                                                                                                               \
+            KERNELS_UNROLL(KS)                                                                                                          \
+            for (int kh = kh0; kh < kh1; kh++)                                                                                          \
+            {                                                                                                                           \
+                KERNELS_UNROLL(KS)                                                                                                      \
+                for (int kw = kw0; kw < kw1; kw++)                                                                                      \
+                {                                                                                                                       \
+                    x = in[ic][ih0 + kh][iw0 + kw];                                                                                     \
+                    KERNELS_UNROLL(OCB)                                                                                                 \
+                    for (int j = 0; j < OCB; j++)                                                                                       \
+                    {                                                                                                                   \
+                        acc[j] += x * (int32_t)w[ic][kh][kw][j];                                                                        \
+                    }                                                                                                                   \
+                }                                                                                                                       \
+            }                                                                                                                           \
+        }                                                                                                                               \
+        KERNELS_UNROLL(OCB)                                                                                                             \
+        for (int j = 0; j < OCB; j++)                                                                                                   \
+        {                                                                                                                               \
+            out[oc0 + j][oh][ow] = EPI(acc[j]);                                                                                         \
+        }                                                                                                                               \
+    }                                                                                                                                   \
+    /* One output row: left edge, branch-free interior, right edge */                                                                   \
+    KERNELS_INLINE void name##_row(const int8_t in[IC][IH][IW], int8_t out[OC][CONV_OUT_DIM(IH, KS, S, P)][CONV_OUT_DIM(IW, KS, S, P)], \
+                                   const int8_t w[IC][KS][KS][OCB], const int32_t b[OCB], int oc0, int oh, int kh0, int kh1)            \
+    {                                                                                                                                   \
+        int ow = 0, iw0;                                                                                                                \
+        for (; ow < CONV_IN_LO(S, P) && ow < CONV_OUT_DIM(IW, KS, S, P); ow++)                                                          \
+        {                                                                                                                               \
+            iw0 = ow * S - P;                                                                                                           \
+            name##_px(in, out, w, b, oc0, oh, ow, kh0, kh1, CONV_TAP_LO(iw0), CONV_TAP_HI(iw0, IW, KS));                                \
+        }                                                                                                                               \
+        for (; ow < CONV_IN_HI(IW, KS, S, P); ow++)                                                                                     \
+        {                                                                                                                               \
+            name##_px(in, out, w, b, oc0, oh, ow, kh0, kh1, 0, KS);                                                                     \
+        }                                                                                                                               \
+        for (; ow < CONV_OUT_DIM(IW, KS, S, P); ow++)                                                                                   \
+        {                                                                                                                               \
+            iw0 = ow * S - P;                                                                                                           \
+            name##_px(in, out, w, b, oc0, oh, ow, kh0, kh1, CONV_TAP_LO(iw0), CONV_TAP_HI(iw0, IW, KS));                                \
+        }                                                                                                                               \
+    }                                                                                                                                   \
+    static void name(const int8_t in[IC][IH][IW], int8_t out[OC][CONV_OUT_DIM(IH, KS, S, P)][CONV_OUT_DIM(IW, KS, S, P)],               \
+                     const int8_t w[(OC) / (OCB)][IC][KS][KS][OCB], const int32_t b[OC])                                                \
+    {                                                                                                                                   \
+        int ih0;                                                                                                                        \
+        for (int ob = 0; ob < (OC) / (OCB); ob++)                                                                                       \
+        {                                                                                                                               \
+            for (int oh = 0; oh < CONV_OUT_DIM(IH, KS, S, P); oh++)                                                                     \
+            {                                                                                                                           \
+                ih0 = oh * S - P;                                                                                                       \
+                if (oh >= CONV_IN_LO(S, P) && oh < CONV_IN_HI(IH, KS, S, P))                                                            \
+                {                                                                                                                       \
+                    name##_row(in, out, w[ob], &b[ob * (OCB)], ob * (OCB), oh, 0, KS);                                                  \
+                }                                                                                                                       \
+                else                                                                                                                    \
+                {                                                                                                                       \
+                    name##_row(in, out, w[ob], &b[ob * (OCB)], ob * (OCB), oh, CONV_TAP_LO(ih0), CONV_TAP_HI(ih0, IH, KS));             \
+                }                                                                                                                       \
+            }                                                                                                                           \
+        }                                                                                                                               \
+    }
+
+#define DEFINE_CONV2D_NHWC_OCB(name, ...) DEFINE_CONV2D_NHWC_OCB_(name, __VA_ARGS__)
+#define DEFINE_CONV2D_NHWC_OCB_(name, IC, IH, IW, OC, KS, S, P, EPI, OCB)                                                 \
+    _Static_assert((OC) % (OCB) == 0, #name ": OC must be a multiple of OCB");                                            \
+    __attribute__((unused)) static const layer_desc_t name##_desc = {                                                     \
+        #name, IC, IH, IW, OC, CONV_OUT_DIM(IH, KS, S, P), CONV_OUT_DIM(IW, KS, S, P), KS, S, P, (epilogue_t)EPI##_EPI};  \
+    static void name(const int8_t in[IH][IW][IC], int8_t out[CONV_OUT_DIM(IH, KS, S, P)][CONV_OUT_DIM(IW, KS, S, P)][OC], \
+                     const int8_t w[(OC) / (OCB)][KS][KS][IC][OCB], const int32_t b[OC])                                  \
+    {                                                                                                                     \
+        int32_t acc[OCB], x;                                                                                              \
+        int ih, iw;                                                                                                       \
+        const int8_t *px, *wp;                                                                                            \
+        for (int oh = 0; oh < CONV_OUT_DIM(IH, KS, S, P); oh++)                                                           \
+        {                                                                                                                 \
+            for (int ow = 0; ow < CONV_OUT_DIM(IW, KS, S, P); ow++)                                                       \
+            {                                                                                                             \
+                for (int ob = 0; ob < (OC) / (OCB); ob++)                                                                 \
+                {                                                                                                         \
+                    KERNELS_UNROLL(OCB)                                                                                   \
+                    for (int j = 0; j < OCB; j++)                                                                         \
+                    {                                                                                                     \
+                        acc[j] = b[ob * (OCB) + j];                                                                       \
+                    }                                                                                                     \
+                    KERNELS_UNROLL(KS)                                                                                    \
+                    for (int kh = 0; kh < KS; kh++)                                                                       \
+                    {                                                                                                     \
+                        ih = oh * S + kh - P;                                                                             \
+                        KERNELS_UNROLL(KS)                                                                                \
+                        for (int kw = 0; kw < KS; kw++)                                                                   \
+                        {                                                                                                 \
+                            iw = ow * S + kw - P;                                                                         \
+                            if ((unsigned)ih < IH && (unsigned)iw < IW)                                                   \
+                            {                                                                                             \
+                                px = in[ih][iw];                                                                          \
+                                wp = w[ob][kh][kw][0];                                                                    \
+                                for (int ic = 0; ic < IC; ic++)                                                           \
+                                {                                                                                         \
+                                    x = px[ic];                                                                           \
+                                    KERNELS_UNROLL(OCB)                                                                   \
+                                    for (int j = 0; j < OCB; j++)                                                         \
+                                    {                                                                                     \
+                                        acc[j] += x * (int32_t)wp[j];                                                     \
+                                    }                                                                                     \
+                                    wp += OCB;                                                                            \
+                                }                                                                                         \
+                            }                                                                                             \
+                        }                                                                                                 \
+                    }                                                                                                     \
+                    KERNELS_UNROLL(OCB)                                                                                   \
+                    for (int j = 0; j < OCB; j++)                                                                         \
+                    {                                                                                                     \
+                        out[oh][ow][ob * (OCB) + j] = EPI(acc[j]);                                                        \
+                    }                                                                                                     \
+                }                                                                                                         \
+            }                                                                                                             \
+        }                                                                                                                 \
+    }
+
+// Repacking from the source layout of each kernel family (weight-load time)
+#define DEFINE_REPACK_OIHW_OCB(name, OC, IC, KS, OCB)                                             \
+    static void name(const int8_t src[OC][IC][KS][KS], int8_t dst[(OC) / (OCB)][IC][KS][KS][OCB]) \
+    {                                                                                             \
+        for (int oc = 0; oc < OC; oc++)                                                           \
+        {                                                                                         \
+            for (int ic = 0; ic < IC; ic++)                                                       \
+            {                                                                                     \
+                for (int kh = 0; kh < KS; kh++)                                                   \
+                {                                                                                 \
+                    for (int kw = 0; kw < KS; kw++)                                               \
+                    {                                                                             \
+                        dst[oc / (OCB)][ic][kh][kw][oc % (OCB)] = src[oc][ic][kh][kw];            \
+                    }                                                                             \
+                }                                                                                 \
+            }                                                                                     \
+        }                                                                                         \
+    }
+#define DEFINE_REPACK_OHWI_OCB(name, OC, IC, KS, OCB)                                             \
+    static void name(const int8_t src[OC][KS][KS][IC], int8_t dst[(OC) / (OCB)][KS][KS][IC][OCB]) \
+    {                                                                                             \
+        for (int oc = 0; oc < OC; oc++)                                                           \
+        {                                                                                         \
+            for (int kh = 0; kh < KS; kh++)                                                       \
+            {                                                                                     \
+                for (int kw = 0; kw < KS; kw++)                                                   \
+                {                                                                                 \
+                    for (int ic = 0; ic < IC; ic++)                                               \
+                    {                                                                             \
+                        dst[oc / (OCB)][kh][kw][ic][oc % (OCB)] = src[oc][kh][kw][ic];            \
+                    }                                                                             \
+                }                                                                                 \
+            }                                                                                     \
+        }                                                                                         \
+    }
+
+// ---- Winograd inner-product variants ----
+// Winograd (1968): with the reduction split in pairs (a0, a1), (w0, w1),
+//   a0*w0 + a1*w1 = (a0 + w1)(a1 + w0) - a0*a1 - w0*w1
+// so a dot product of length N takes N/2 multiplies plus two pair terms. The
+// weight pairs xi = sum w0*w1 are subtracted from the bias once, at pack time
+// (bw = b - xi); the activation pairs eta = sum a0*a1 depend on the input only
+// and are computed once per output position for all OC (convs: per-pixel
+// channel-pair products, then a KSxKS window sum). Pairs run along the input
+// channels at the same tap. Exact in int32: the result is bit-identical to the
+// direct kernels (CHW activations; weights packed [OC][IC/2][KS][KS][2] as
+// {w[2j+1], w[2j]}, FC [OUT][IN/2][2]).
+#define DEFINE_WINO_PACK_CONV(name, OC, IC, KS)                                                                               \
+    _Static_assert((IC) % 2 == 0, #name ": IC must be even");                                                                 \
+    static void name(const int8_t w[OC][IC][KS][KS], const int32_t b[OC], int8_t wp[OC][(IC) / 2][KS][KS][2], int32_t bw[OC]) \
+    {                                                                                                                         \
+        int32_t xi;                                                                                                           \
+        for (int oc = 0; oc < OC; oc++)                                                                                       \
+        {                                                                                                                     \
+            xi = 0;                                                                                                           \
+            for (int j = 0; j < (IC) / 2; j++)                                                                                \
+            {                                                                                                                 \
+                for (int kh = 0; kh < KS; kh++)                                                                               \
+                {                                                                                                             \
+                    for (int kw = 0; kw < KS; kw++)                                                                           \
+                    {                                                                                                         \
+                        wp[oc][j][kh][kw][0] = w[oc][2 * j + 1][kh][kw];                                                      \
+                        wp[oc][j][kh][kw][1] = w[oc][2 * j][kh][kw];                                                          \
+                        xi += (int32_t)w[oc][2 * j][kh][kw] * (int32_t)w[oc][2 * j + 1][kh][kw];                              \
+                    }                                                                                                         \
+                }                                                                                                             \
+            }                                                                                                                 \
+            bw[oc] = b[oc] - xi;                                                                                              \
+        }                                                                                                                     \
+    }
+
+// Convolution with fused epilogue on Winograd-packed weights; zero padding
+// included (the pair terms need the full window).
+#define DEFINE_CONV2D_WINO(name, ...) DEFINE_CONV2D_WINO_(name, __VA_ARGS__)
+#define DEFINE_CONV2D_WINO_(name, IC, IH, IW, OC, KS, S, P, EPI)                                                                      \
+    _Static_assert((IC) % 2 == 0, #name ": IC must be even");                                                                         \
+    /* Pair products of a window entirely inside the input */                                                                         \
+    KERNELS_INLINE int32_t name##_window(const int8_t in[IC][IH][IW], const int8_t wp[(IC) / 2][KS][KS][2], int ih0, int iw0)         \
+    {                                                                                                                                 \
+        int32_t acc = 0;                                                                                                              \
+        for (int j = 0; j < (IC) / 2; j++)                                                                                            \
+        {                                                                                                                             \
+            KERNELS_UNROLL(KS)                                                                                                        \
+            for (int kh = 0; kh < KS; kh++)                                                                                           \
+            {                                                                                                                         \
+                KERNELS_UNROLL(KS)                                                                                                    \
+                for (int kw = 0; kw < KS; kw++)                                                                                       \
+                {                                                                                                                     \
+                    acc += ((int32_t)in[2 * j][ih0 + kh][iw0 + kw] + wp[j][kh][kw][0]) *                                              \
+                           ((int32_t)in[2 * j + 1][ih0 + kh][iw0 + kw] + wp[j][kh][kw][1]);                                           \
+                }                                                                                                                     \
+            }                                                                                                                         \
+        }                                                                                                                             \
+        return acc;                                                                                                                   \
+    }                                                                                                                                 \
+    /* Border window: a padding tap has a = 0 and leaves the weight-pair product */                                                   \
+    static int32_t name##_window_pad(const int8_t in[IC][IH][IW], const int8_t wp[(IC) / 2][KS][KS][2], int ih0, int iw0)             \
+    {                                                                                                                                 \
+        int32_t acc = 0;                                                                                                              \
+        int ih, iw;                                                                                                                   \
+        for (int j = 0; j < (IC) / 2; j++)                                                                                            \
+        {                                                                                                                             \
+            for (int kh = 0; kh < KS; kh++)                                                                                           \
+            {                                                                                                                         \
+                for (int kw = 0; kw < KS; kw++)                                                                                       \
+                {                                                                                                                     \
+                    ih = ih0 + kh;                                                                                                    \
+                    iw = iw0 + kw;                                                                                                    \
+                    if (ih >= 0 && ih < IH && iw >= 0 && iw < IW)                                                                     \
+                    {                                                                                                                 \
+                        acc += ((int32_t)in[2 * j][ih][iw] + wp[j][kh][kw][0]) * ((int32_t)in[2 * j + 1][ih][iw] + wp[j][kh][kw][1]); \
+                    }                                                                                                                 \
+                    else                                                                                                              \
+                    {                                                                                                                 \
+                        acc += (int32_t)wp[j][kh][kw][0] * (int32_t)wp[j][kh][kw][1];                                                 \
+                    }                                                                                                                 \
+                }                                                                                                                     \
+            }                                                                                                                         \
+        }                                                                                                                             \
+        return acc;                                                                                                                   \
+    }                                                                                                                                 \
+    static void name(const int8_t in[IC][IH][IW], int8_t out[OC][CONV_OUT_DIM(IH, KS, S, P)][CONV_OUT_DIM(IW, KS, S, P)],             \
+                     const int8_t wp[OC][(IC) / 2][KS][KS][2], const int32_t bw[OC])                                                  \
+    {                                                                                                                                 \
+        int32_t pair[IH][IW], eta[CONV_OUT_DIM(IW, KS, S, P)], e;                                                                     \
+        int ih0, iw0, ow, row_in;                                                                                                     \
+        /* Activation pairs of every pixel, shared by all OC */                                                                       \
+        for (int ih = 0; ih < IH; ih++)                                                                                               \
+        {                                                                                                                             \
+            for (int iw = 0; iw < IW; iw++)                                                                                           \
+            {                                                                                                                         \
+                e = 0;                                                                                                                \
+                for (int j = 0; j < (IC) / 2; j++)                                                                                    \
+                {                                                                                                                     \
+                    e += (int32_t)in[2 * j][ih][iw] * (int32_t)in[2 * j + 1][ih][iw];                                                 \
+                }                                                                                                                     \
+                pair[ih][iw] = e;                                                                                                     \
+            }                                                                                                                         \
+        }                                                                                                                             \
+        for (int oh = 0; oh < CONV_OUT_DIM(IH, KS, S, P); oh++)                                                                       \
+        {                                                                                                                             \
+            ih0 = oh * S - P;                                                                                                         \
+            row_in = oh >= CONV_IN_LO(S, P) && oh < CONV_IN_HI(IH, KS, S, P);                                                         \
+            for (ow = 0; ow < CONV_OUT_DIM(IW, KS, S, P); ow++)                                                                       \
+            {                                                                                                                         \
+                iw0 = ow * S - P;                                                                                                     \
+                e = 0;                                                                                                                \
+                for (int kh = CONV_TAP_LO(ih0); kh < CONV_TAP_HI(ih0, IH, KS); kh++)                                                  \
+                {                                                                                                                     \
+                    for (int kw = CONV_TAP_LO(iw0); kw < CONV_TAP_HI(iw0, IW, KS); kw++)                                              \
+                    {                                                                                                                 \
+                        e += pair[ih0 + kh][iw0 + kw];                                                                                \
+                    }                                                                                                                 \
+                }                                                                                                                     \
+                eta[ow] = e;                                                                                                          \
+            }                                                                                                                         \
+            for (int oc = 0; oc < OC; oc++)                                                                                           \
+            {                                                                                                                         \
+                if (!row_in)                                                                                                          \
+                {                                                                                                                     \
+                    for (ow = 0; ow < CONV_OUT_DIM(IW, KS, S, P); ow++)                                                               \
+                    {                                                                                                                 \
+                        out[oc][oh][ow] = EPI(bw[oc] - eta[ow] + name##_window_pad(in, wp[oc], ih0, ow * S - P));                     \
+                    }                                                                                                                 \
+                    continue;                                                                                                         \
+                }                                                                                                                     \
+                for (ow = 0; ow < CONV_IN_LO(S, P) && ow < CONV_OUT_DIM(IW, KS, S, P); ow++)                                          \
+                {                                                                                                                     \
+                    out[oc][oh][ow] = EPI(bw[oc] - eta[ow] + name##_window_pad(in, wp[oc], ih0, ow * S - P));                         \
+                }                                                                                                                     \
+                for (; ow < CONV_IN_HI(IW, KS, S, P); ow++)                                                                           \
+                {                                                                                                                     \
+                    out[oc][oh][ow] = EPI(bw[oc] - eta[ow] + name##_window(in, wp[oc], ih0, ow * S - P));                             \
+                }                                                                                                                     \
+                for (; ow < CONV_OUT_DIM(IW, KS, S, P); ow++)                                                                         \
+                {                                                                                                                     \
+                    out[oc][oh][ow] = EPI(bw[oc] - eta[ow] + name##_window_pad(in, wp[oc], ih0, ow * S - P));                         \
+                }                                                                                                                     \
+            }                                                                                                                         \
+        }                                                                                                                             \
+    }
+
+#define DEFINE_WINO_PACK_FC(name, OUT, IN)                                                                        \
+    _Static_assert((IN) % 2 == 0, #name ": IN must be even");                                                     \
+    static void name(const int8_t w[OUT][IN], const int32_t b[OUT], int8_t wp[OUT][(IN) / 2][2], int32_t bw[OUT]) \
+    {                                                                                                             \
+        int32_t xi;                                                                                               \
+        for (int c = 0; c < OUT; c++)                                                                             \
+        {                                                                                                         \
+            xi = 0;                                                                                               \
+            for (int j = 0; j < (IN) / 2; j++)                                                                    \
+            {                                                                                                     \
+                wp[c][j][0] = w[c][2 * j + 1];                                                                    \
+                wp[c][j][1] = w[c][2 * j];                                                                        \
+                xi += (int32_t)w[c][2 * j] * (int32_t)w[c][2 * j + 1];                                            \
+            }                                                                                                     \
+            bw[c] = b[c] - xi;                                                                                    \
+        }                                                                                                         \
+    }
+
+// Fully connected layer on Winograd-packed weights (eta shared by all outputs)
+#define DEFINE_FC_WINO(name, IN, OUT, EPI)                                                                                   \
+    _Static_assert((IN) % 2 == 0, #name ": IN must be even");                                                                \
+    static void name(const int8_t in_vec[IN], int8_t out_vec[OUT], const int8_t wp[OUT][(IN) / 2][2], const int32_t bw[OUT]) \
+    {                                                                                                                        \
+        int32_t acc, eta = 0;                                                                                                \
+        for (int j = 0; j < (IN) / 2; j++)                                                                                   \
+        {                                                                                                                    \
+            eta += (int32_t)in_vec[2 * j] * (int32_t)in_vec[2 * j + 1];                                                      \
+        }                                                                                                                    \
+        for (int c = 0; c < OUT; c++)                                                                                        \
+        {                                                                                                                    \
+            acc = bw[c] - eta;                                                                                               \
+            for (int j = 0; j < (IN) / 2; j++)                                                                               \
+            {                                                                                                                \
+                acc += ((int32_t)in_vec[2 * j] + wp[c][j][0]) * ((int32_t)in_vec[2 * j + 1] + wp[c][j][1]);                  \
+            }                                                                                                                \
+            out_vec[c] = EPI(acc);                                                                                           \
+        }                                                                                                                    \
+    }
+
+// ---- Cache-blocked (tiled) variants ----
+// DEFINE_CONV2D walks oc -> oh -> ow -> ic, so every output channel sweeps the
+// whole IC x IH x IW input once. The tiled schedule works on a strip of TOH
+// output rows at a time; inside it, TOC output channels accumulate in int32
+// while the input channels go by in chunks of TIC:
+//
+//   for each strip of TOH output rows
+//     for each group of TOC output channels     acc[TOC][TOH][OW] = bias
+//       for each chunk of TIC input channels    acc += w[group][chunk] * in[chunk][strip rows]
+//       epilogue of the group
+//
+// The TIC x (TOH*S + KS - S) x IW input rows of a chunk are reused by TOC
+// channels, and the strip's input (IC x rows x IW) is reused by all OC / TOC
+// groups, so it is read from the next level once per strip if it fits the
+// cache. The channel planes are a power of two apart and map to the same sets,
+// so it is the ways, not the size, that bound TIC. Same layouts as DEFINE_CONV2D (CHW, OIHW weights), bit-exact results.
+// The partial sums live on the stack (TOC x TOH x OW int32, at most
+// KERNELS_TILE_ACC_MAX bytes). Tile sizes per cache size: tiling.h.
+#ifndef KERNELS_TILE_ACC_MAX
+#define KERNELS_TILE_ACC_MAX 4096
+#endif
+#define DEFINE_CONV2D_TILED(name, ...) DEFINE_CONV2D_TILED_(name, __VA_ARGS__)
+#define DEFINE_CONV2D_TILED_(name, IC, IH, IW, OC, KS, S, P, EPI, TOC, TOH, TIC)                                                 \
+    _Static_assert((OC) % (TOC) == 0, #name ": OC must be a multiple of TOC");                                                   \
+    _Static_assert(CONV_OUT_DIM(IH, KS, S, P) % (TOH) == 0, #name ": output rows must be a multiple of TOH");                    \
+    _Static_assert((IC) % (TIC) == 0, #name ": IC must be a multiple of TIC");                                                   \
+    _Static_assert((TOC) * (TOH) * CONV_OUT_DIM(IW, KS, S, P) * 4 <= KERNELS_TILE_ACC_MAX, #name ": TOC x TOH strip too large"); \
+    __attribute__((unused)) static const layer_desc_t name##_desc = {                                                            \
+        #name, IC, IH, IW, OC, CONV_OUT_DIM(IH, KS, S, P), CONV_OUT_DIM(IW, KS, S, P), KS, S, P, (epilogue_t)EPI##_EPI};         \
+    /* Taps [kh0, kh1) x [kw0, kw1) of input channels [ic0, ic0 + TIC) */                                                        \
+    KERNELS_INLINE int32_t name##_window(const int8_t in[IC][IH][IW], const int8_t w[IC][KS][KS], int ic0,                       \
+                                         int ih0, int iw0, int kh0, int kh1, int kw0, int kw1)                                   \
+    {                                                                                                                            \
+        int32_t acc = 0;                                                                                                         \
+        for (int ic = ic0; ic < ic0 + (TIC); ic++)                                                                               \
+        {                                                                                                                        \
+            KERNELS_UNROLL(KS)                                                                                                   \
+            for (int kh = kh0; kh < kh1; kh++)                                                                                   \
+            {                                                                                                                    \
+                KERNELS_UNROLL(KS)                                                                                               \
+                for (int kw = kw0; kw < kw1; kw++)                                                                               \
+                {                                                                                                                \
+                    acc += (int32_t)in[ic][ih0 + kh][iw0 + kw] * (int32_t)w[ic][kh][kw];                                         \
+                }                                                                                                                \
+            }                                                                                                                    \
+        }                                                                                                                        \
+        return acc;                                                                                                              \
+    }                                                                                                                            \
+    /* Adds one input-channel chunk to a row of partial sums */                                                                  \
+    KERNELS_INLINE void name##_row(const int8_t in[IC][IH][IW], int32_t acc[CONV_OUT_DIM(IW, KS, S, P)],                         \
+                                   const int8_t w[IC][KS][KS], int ic0, int ih0, int kh0, int kh1)                               \
+    {                                                                                                                            \
+        int ow = 0, iw0;                                                                                                         \
+        for (; ow < CONV_IN_LO(S, P) && ow < CONV_OUT_DIM(IW, KS, S, P); ow++)                                                   \
+        {                                                                                                                        \
+            iw0 = ow * S - P;                                                                                                    \
+            acc[ow] += name##_window(in, w, ic0, ih0, iw0, kh0, kh1, CONV_TAP_LO(iw0), CONV_TAP_HI(iw0, IW, KS));                \
+        }                                                                                                                        \
+        for (; ow < CONV_IN_HI(IW, KS, S, P); ow++)                                                                              \
+        {                                                                                                                        \
+            acc[ow] += name##_window(in, w, ic0, ih0, ow * S - P, kh0, kh1, 0, KS);                                              \
+        }                                                                                                                        \
+        for (; ow < CONV_OUT_DIM(IW, KS, S, P); ow++)                                                                            \
+        {                                                                                                                        \
+            iw0 = ow * S - P;                                                                                                    \
+            acc[ow] += name##_window(in, w, ic0, ih0, iw0, kh0, kh1, CONV_TAP_LO(iw0), CONV_TAP_HI(iw0, IW, KS));                \
+        }                                                                                                                        \
+    }                                                                                                                            \
+    static void name(const int8_t in[IC][IH][IW], int8_t out[OC][CONV_OUT_DIM(IH, KS, S, P)][CONV_OUT_DIM(IW, KS, S, P)],        \
+                     const int8_t w[OC][IC][KS][KS], const int32_t b[OC])                                                        \
+    {                                                                                                                            \
+        int32_t acc[TOC][TOH][CONV_OUT_DIM(IW, KS, S, P)];                                                                       \
+        int oh, ih0;                                                                                                             \
+        for (int oh0 = 0; oh0 < CONV_OUT_DIM(IH, KS, S, P); oh0 += (TOH))                                                        \
+        {                                                                                                                        \
+            for (int oc0 = 0; oc0 < (OC); oc0 += (TOC))                                                                          \
+            {                                                                                                                    \
+                for (int j = 0; j < (TOC); j++)                                                                                  \
+                {                                                                                                                \
+                    for (int r = 0; r < (TOH); r++)                                                                              \
+                    {                                                                                                            \
+                        for (int ow = 0; ow < CONV_OUT_DIM(IW, KS, S, P); ow++)                                                  \
+                        {                                                                                                        \
+                            acc[j][r][ow] = b[oc0 + j];                                                                          \
+                        }                                                                                                        \
+                    }                                                                                                            \
+                }                                                                                                                \
+                for (int ic0 = 0; ic0 < (IC); ic0 += (TIC))                                                                      \
+                {                                                                                                                \
+                    for (int j = 0; j < (TOC); j++)                                                                              \
+                    {                                                                                                            \
+                        for (int r = 0; r < (TOH); r++)                                                                          \
+                        {                                                                                                        \
+                            oh = oh0 + r;                                                                                        \
+                            ih0 = oh * S - P;                                                                                    \
+                            if (oh >= CONV_IN_LO(S, P) && oh < CONV_IN_HI(IH, KS, S, P))                                         \
+                            {                                                                                                    \
+                                name##_row(in, acc[j][r], w[oc0 + j], ic0, ih0, 0, KS);                                          \
+                            }                                                                                                    \
+                            else                                                                                                 \
+                            {                                                                                                    \
+                                name##_row(in, acc[j][r], w[oc0 + j], ic0, ih0, CONV_TAP_LO(ih0), CONV_TAP_HI(ih0, IH, KS));     \
+                            }                                                                                                    \
+                        }                                                                                                        \
+                    }                                                                                                            \
+                }                                                                                                                \
+                for (int j = 0; j < (TOC); j++)                                                                                  \
+                {                                                                                                                \
+                    for (int r = 0; r < (TOH); r++)                                                                              \
+                    {                                                                                                            \
+                        for (int ow = 0; ow < CONV_OUT_DIM(IW, KS, S, P); ow++)                                                  \
+                        {                                                                                                        \
+                            out[oc0 + j][oh0 + r][ow] = EPI(acc[j][r][ow]);                                                      \
+                        }                                                                                                        \
+                    }                                                                                                            \
+                }                                                                                                                \
+            }                                                                                                                    \
+        }                                                                                                                        \
+    }
+
+// ---- Activation-sparsity (zero-skipping) variants ----
+// After a ReLU, or the clamped skip add, many activations are exactly zero,
+// but DEFINE_CONV2D still multiplies every one of them. Here each producing
+// layer also writes a nonzero bitmap: one uint32_t per channel row, with bit w
+// set iff x[c][h][w] != 0 (so W <= 32).
+//
+// The consuming convolution walks only the set bits. For one output channel,
+// it scatters each nonzero input through its KS x KS taps into the OH x OW
+// int32 accumulators. A run of zeros costs nothing but the bit scan, and an
+// all-zero row costs one test. Padding needs no test: only real inputs are
+// scattered.
+//
+// Unit stride only, with CHW activations and OIHW weights. The scatter only
+// reorders exact int32 additions that cannot overflow, so the result equals
+// DEFINE_CONV2D bit for bit. Each MAC loads and stores its accumulator, where
+// DEFINE_CONV2D keeps the sum in a register, so the break-even density depends
+// on the core; sparse.h reports both per layer.
+
+// Index of the lowest set bit of x != 0 (de Bruijn multiply: no Zbb, no libgcc call)
+KERNELS_INLINE int kernels_ctz32(uint32_t x)
+{
+    static const uint8_t pos[32] = {0,  1,  28, 2,  29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4,  8,
+                                    31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6,  11, 5,  10, 9};
+    return pos[((x & (0u - x)) * 0x077CB531u) >> 27];
+}
+
+// Nonzero bitmap of an activation produced by a kernel that does not emit one
+#define DEFINE_ACT_NZ(name, C, H, W)                                           \
+    _Static_assert((W) <= 32, #name ": one bitmap word per row");              \
+    static void name(const int8_t in[C][H][W], uint32_t nz[C][H])              \
+    {                                                                          \
+        uint32_t bits;                                                         \
+        for (int c = 0; c < C; c++)                                            \
+        {                                                                      \
+            for (int h = 0; h < H; h++)                                        \
+            {                                                                  \
+                bits = 0;                                                      \
+                for (int w = 0; w < W; w++)                                    \
+                {                                                              \
+                    bits |= (uint32_t)(in[c][h][w] != 0) << w;                 \
+                }                                                              \
+                nz[c][h] = bits;                                               \
+            }                                                                  \
+        }                                                                      \
+    }
+
+// Residual skip add (DEFINE_SKIP_ADD_RELU) that also writes the nonzero bitmap
+// of its output; nz may be 0 when no sparse layer reads it
+#define DEFINE_SKIP_ADD_RELU_NZ(name, C, H, W)                                                                 \
+    _Static_assert((W) <= 32, #name ": one bitmap word per row");                                              \
+    static void name(const int8_t a[C][H][W], const int8_t b[C][H][W], int8_t out[C][H][W], uint32_t nz[C][H]) \
+    {                                                                                                          \
+        int32_t s;                                                                                             \
+        uint32_t bits;                                                                                         \
+        for (int c = 0; c < C; c++)                                                                            \
+        {                                                                                                      \
+            for (int h = 0; h < H; h++)                                                                        \
+            {                                                                                                  \
+                bits = 0;                                                                                      \
+                for (int w = 0; w < W; w++)                                                                    \
+                {                                                                                              \
+                    s = (int32_t)a[c][h][w] + (int32_t)b[c][h][w];                                             \
+                    if (s < 0)                                                                                 \
+                    {                                                                                          \
+                        s = 0;                                                                                 \
+                    }                                                                                          \
+                    else if (s > 127)                                                                          \
+                    {                                                                                          \
+                        s = 127;                                                                               \
+                    }                                                                                          \
+                    out[c][h][w] = (int8_t)s;                                                                  \
+                    bits |= (uint32_t)(s != 0) << w;                                                           \
+                }                                                                                              \
+                if (nz)                                                                                        \
+                {                                                                                              \
+                    nz[c][h] = bits;                                                                           \
+                }                                                                                              \
+            }                                                                                                  \
+        }                                                                                                      \
+    }
+
+// Convolution over the nonzero inputs only (in_nz), with fused epilogue; writes
+// the nonzero bitmap of its output to out_nz unless it is 0
+#define DEFINE_CONV2D_SPARSE(name, ...) DEFINE_CONV2D_SPARSE_(name, __VA_ARGS__)
+#define DEFINE_CONV2D_SPARSE_(name, IC, IH, IW, OC, KS, S, P, EPI)                                                                             \
+    _Static_assert((S) == 1, #name ": the scatter form needs unit stride");                                                                    \
+    _Static_assert((IW) <= 32 && CONV_OUT_DIM(IW, KS, S, P) <= 32, #name ": one bitmap word per row");                                         \
+    _Static_assert(CONV_OUT_DIM(IH, KS, S, P) * CONV_OUT_DIM(IW, KS, S, P) * 4 <= KERNELS_TILE_ACC_MAX,                                        \
+                   #name ": output plane too large for the accumulators");                                                                     \
+    __attribute__((unused)) static const layer_desc_t name##_desc = {                                                                          \
+        #name, IC, IH, IW, OC, CONV_OUT_DIM(IH, KS, S, P), CONV_OUT_DIM(IW, KS, S, P), KS, S, P, (epilogue_t)EPI##_EPI};                       \
+    /* Input (ih, iw) reaches the outputs (ih + P - kh, iw + P - kw) */                                                                        \
+    KERNELS_INLINE void name##_scatter(const int8_t row[IW], uint32_t nz, int32_t acc[CONV_OUT_DIM(IH, KS, S, P)][CONV_OUT_DIM(IW, KS, S, P)], \
+                                       const int32_t wk[KS][KS], int ih)                                                                       \
+    {                                                                                                                                          \
+        int kh0 = ih + (P) + 1 > CONV_OUT_DIM(IH, KS, S, P) ? ih + (P) + 1 - CONV_OUT_DIM(IH, KS, S, P) : 0;                                   \
+        int kh1 = ih + (P) + 1 < (KS) ? ih + (P) + 1 : (KS);                                                                                   \
+        int iw, kw0, kw1;                                                                                                                      \
+        int32_t x;                                                                                                                             \
+        while (nz)                                                                                                                             \
+        {                                                                                                                                      \
+            iw = kernels_ctz32(nz);                                                                                                            \
+            nz &= nz - 1;                                                                                                                      \
+            x = row[iw];                                                                                                                       \
+            if (iw >= (KS) - 1 - (P) && iw + (P) < CONV_OUT_DIM(IW, KS, S, P))                                                                 \
+            {                                                                                                                                  \
+                KERNELS_UNROLL(KS)                                                                                                             \
+                for (int kh = kh0; kh < kh1; kh++)                                                                                             \
+                {                                                                                                                              \
+                    KERNELS_UNROLL(KS)                                                                                                         \
+                    for (int kw = 0; kw < KS; kw++)                                                                                            \
+                    {                                                                                                                          \
+                        acc[ih + P - kh][iw + P - kw] += x * wk[kh][kw];                                                                       \
+                    }                                                                                                                          \
+                }                                                                                                                              \
+            }                                                                                                                                  \
+            else                                                                                                                               \
+            {                                                                                                                                  \
+                kw0 = iw + (P) + 1 > CONV_OUT_DIM(IW, KS, S, P) ? iw + (P) + 1 - CONV_OUT_DIM(IW, KS, S, P) : 0;                               \
+                kw1 = iw + (P) + 1 < (KS) ? iw + (P) + 1 : (KS);                                                                               \
+                for (int kh = kh0; kh < kh1; kh++)                                                                                             \
+                {                                                                                                                              \
+                    for (int kw = kw0; kw < kw1; kw++)                                                                                         \
+                    {                                                                                                                          \
+                        acc[ih + P - kh][iw + P - kw] += x * wk[kh][kw];                                                                       \
+                    }                                                                                                                          \
+                }                                                                                                                              \
+            }                                                                                                                                  \
+        }                                                                                                                                      \
+    }                                                                                                                                          \
+    static void name(const int8_t in[IC][IH][IW], const uint32_t in_nz[IC][IH],                                                                \
+                     int8_t out[OC][CONV_OUT_DIM(IH, KS, S, P)][CONV_OUT_DIM(IW, KS, S, P)],                                                   \
+                     uint32_t out_nz[OC][CONV_OUT_DIM(IH, KS, S, P)], const int8_t w[OC][IC][KS][KS], const int32_t b[OC])                     \
+    {                                                                                                                                          \
+        int32_t acc[CONV_OUT_DIM(IH, KS, S, P)][CONV_OUT_DIM(IW, KS, S, P)];                                                                   \
+        int32_t wk[KS][KS]; /* taps of (oc, ic) in registers: the int8 weights may alias acc */                                                \
+        uint32_t bits;                                                                                                                         \
+        int8_t v;                                                                                                                              \
+        for (int oc = 0; oc < OC; oc++)                                                                                                        \
+        {                                                                                                                                      \
+            for (int oh = 0; oh < CONV_OUT_DIM(IH, KS, S, P); oh++)                                                                            \
+            {                                                                                                                                  \
+                for (int ow = 0; ow < CONV_OUT_DIM(IW, KS, S, P); ow++)                                                                        \
+                {                                                                                                                              \
+                    acc[oh][ow] = b[oc];                                                                                                       \
+                }                                                                                                                              \
+            }                                                                                                                                  \
+            for (int ic = 0; ic < IC; ic++)                                                                                                    \
+            {                                                                                                                                  \
+                KERNELS_UNROLL(KS)                                                                                                             \
+                for (int kh = 0; kh < KS; kh++)                                                                                                \
+                {                                                                                                                              \
+                    KERNELS_UNROLL(KS)                                                                                                         \
+                    for (int kw = 0; kw < KS; kw++)                                                                                            \
+                    {                                                                                                                          \
+                        wk[kh][kw] = w[oc][ic][kh][kw];                                                                                        \
+                    }                                                                                                                          \
+                }                                                                                                                              \
+                for (int ih = 0; ih < IH; ih++)                                                                                                \
+                {                                                                                                                              \
+                    name##_scatter(in[ic][ih], in_nz[ic][ih], acc, wk, ih);                                                                    \
+                }                                                                                                                              \
+            }                                                                                                                                  \
+            for (int oh = 0; oh < CONV_OUT_DIM(IH, KS, S, P); oh++)                                                                            \
+            {                                                                                                                                  \
+                bits = 0;                                                                                                                      \
+                for (int ow = 0; ow < CONV_OUT_DIM(IW, KS, S, P); ow++)                                                                        \
+                {                                                                                                                              \
+                    v = EPI(acc[oh][ow]);                                                                                                      \
+                    out[oc][oh][ow] = v;                                                                                                       \
+                    bits |= (uint32_t)(v != 0) << ow;                                                                                          \
+                }                                                                                                                              \
+                if (out_nz)                                                                                                                    \
+                {                                                                                                                              \
+                    out_nz[oc][oh] = bits;                                                                                                     \
+                }                                                                                                                              \
+            }                                                                                                                                  \
+        }                                                                                                                                      \
+    }
+
+// ---- Depthwise-separable variants ----
+// A KSxKS convolution over all IC channels costs IC*KS*KS MACs per output. The
+// separable pair costs KS*KS + IC: a depthwise KSxKS conv filters every channel
+// on its own, then a pointwise 1x1 conv mixes the channels. For the 32-channel
+// 3x3 residual convs that is 288 + 1024 MACs per pixel instead of 9216. Same
+// epilogues and CHW activations as DEFINE_CONV2D; depthwise weights [C][KS][KS],
+// pointwise weights [OC][IC] (OIHW with 1x1 taps).
+
+// Depthwise convolution: channel c of out only reads channel c of in
+#define DEFINE_DWCONV2D(name, ...) DEFINE_DWCONV2D_(name, __VA_ARGS__)
+#define DEFINE_DWCONV2D_(name, C, IH, IW, KS, S, P, EPI)                                                                \
+    __attribute__((unused)) static const layer_desc_t name##_desc = {                                                   \
+        #name, C, IH, IW, C, CONV_OUT_DIM(IH, KS, S, P), CONV_OUT_DIM(IW, KS, S, P), KS, S, P, (epilogue_t)EPI##_EPI};  \
+    /* Taps [kh0, kh1) x [kw0, kw1) of the window at (ih0, iw0) */                                                      \
+    KERNELS_INLINE int32_t name##_window(const int8_t in[IH][IW], const int32_t wk[KS][KS], int ih0, int iw0,           \
+                                         int kh0, int kh1, int kw0, int kw1)                                            \
+    {                                                                                                                   \
+        int32_t acc = 0;                                                                                                \
+        KERNELS_UNROLL(KS)                                                                                              \
+        for (int kh = kh0; kh < kh1; kh++)                                                                              \
+        {                                                                                                               \
+            KERNELS_UNROLL(KS)                                                                                          \
+            for (int kw = kw0; kw < kw1; kw++)                                                                          \
+            {                                                                                                           \
+                acc += (int32_t)in[ih0 + kh][iw0 + kw] * wk[kh][kw];                                                    \
+            }                                                                                                           \
+        }                                                                                                               \
+        return acc;                                                                                                     \
+    }                                                                                                                   \
+    /* Interior outputs [ow0, ow1) of a row whose KS input rows are all inside, unit                                    \
+       stride: the window slides by one column, so each output loads KS new inputs                                      \
+       and reuses the other KS x (KS - 1) from registers */                                                             \
+    KERNELS_INLINE void name##_slide(const int8_t in[IH][IW], int8_t out[CONV_OUT_DIM(IW, KS, S, P)],                   \
+                                     const int32_t wk[KS][KS], int32_t b, int ih0, int ow0, int ow1)                    \
+    {                                                                                                                   \
+        int32_t x[KS][KS], acc;                                                                                         \
+        KERNELS_UNROLL(KS)                                                                                              \
+        for (int kh = 0; kh < KS; kh++)                                                                                 \
+        {                                                                                                               \
+            KERNELS_UNROLL(KS)                                                                                          \
+            for (int kw = 1; kw < KS; kw++)                                                                             \
+            {                                                                                                           \
+                x[kh][kw] = in[ih0 + kh][ow0 - (P) + kw - 1];                                                           \
+            }                                                                                                           \
+        }                                                                                                               \
+        KERNELS_UNROLL(KS)                                                                                              \
+        for (int ow = ow0; ow < ow1; ow++)                                                                              \
+        {                                                                                                               \
+            acc = b;                                                                                                    \
+            KERNELS_UNROLL(KS)                                                                                          \
+            for (int kh = 0; kh < KS; kh++)                                                                             \
+            {                                                                                                           \
+                KERNELS_UNROLL(KS)                                                                                      \
+                for (int kw = 0; kw < KS - 1; kw++)                                                                     \
+                {                                                                                                       \
+                    x[kh][kw] = x[kh][kw + 1];                                                                          \
+                }                                                                                                       \
+                x[kh][KS - 1] = in[ih0 + kh][ow - (P) + KS - 1];                                                        \
+                KERNELS_UNROLL(KS)                                                                                      \
+                for (int kw = 0; kw < KS; kw++)                                                                         \
+                {                                                                                                       \
+                    acc += x[kh][kw] * wk[kh][kw];                                                                      \
+                }                                                                                                       \
+            }                                                                                                           \
+            out[ow] = EPI(acc);                                                                                         \
+        }                                                                                                               \
+    }                                                                                                                   \
+    /* One output row: left edge, interior, right edge */                                                               \
+    KERNELS_INLINE void name##_row(const int8_t in[IH][IW], int8_t out[CONV_OUT_DIM(IW, KS, S, P)],                     \
+                                   const int32_t wk[KS][KS], int32_t b, int ih0, int kh0, int kh1)                      \
+    {                                                                                                                   \
+        int ow = 0, iw0;                                                                                                \
+        for (; ow < CONV_IN_LO(S, P) && ow < CONV_OUT_DIM(IW, KS, S, P); ow++)                                          \
+        {                                                                                                               \
+            iw0 = ow * S - P;                                                                                           \
+            out[ow] = EPI(b + name##_window(in, wk, ih0, iw0, kh0, kh1, CONV_TAP_LO(iw0), CONV_TAP_HI(iw0, IW, KS)));   \
+        }                                                                                                               \
+        if ((S) == 1 && kh0 == 0 && kh1 == (KS) && ow < CONV_IN_HI(IW, KS, S, P))                                       \
+        {                                                                                                               \
+            name##_slide(in, out, wk, b, ih0, ow, CONV_IN_HI(IW, KS, S, P));                                            \
+            ow = CONV_IN_HI(IW, KS, S, P);                                                                              \
+        }                                                                                                               \
+        for (; ow < CONV_IN_HI(IW, KS, S, P); ow++)                                                                     \
+        {                                                                                                               \
+            out[ow] = EPI(b + name##_window(in, wk, ih0, ow * S - P, kh0, kh1, 0, KS));                                 \
+        }                                                                                                               \
+        for (; ow < CONV_OUT_DIM(IW, KS, S, P); ow++)                                                                   \
+        {                                                                                                               \
+            iw0 = ow * S - P;                                                                                           \
+            out[ow] = EPI(b + name##_window(in, wk, ih0, iw0, kh0, kh1, CONV_TAP_LO(iw0), CONV_TAP_HI(iw0, IW, KS)));   \
+        }                                                                                                               \
+    }                                                                                                                   \
+    static void name(const int8_t in[C][IH][IW], int8_t out[C][CONV_OUT_DIM(IH, KS, S, P)][CONV_OUT_DIM(IW, KS, S, P)], \
+                     const int8_t w[C][KS][KS], const int32_t b[C])                                                     \
+    {                                                                                                                   \
+        int32_t wk[KS][KS]; /* taps of channel c, widened once for all its rows */                                      \
+        int ih0;                                                                                                        \
+        for (int c = 0; c < C; c++)                                                                                     \
+        {                                                                                                               \
+            KERNELS_UNROLL(KS)                                                                                          \
+            for (int kh = 0; kh < KS; kh++)                                                                             \
+            {                                                                                                           \
+                KERNELS_UNROLL(KS)                                                                                      \
+                for (int kw = 0; kw < KS; kw++)                                                                         \
+                {                                                                                                       \
+                    wk[kh][kw] = w[c][kh][kw];                                                                          \
+                }                                                                                                       \
+            }                                                                                                           \
+            for (int oh = 0; oh < CONV_OUT_DIM(IH, KS, S, P); oh++)                                                     \
+            {                                                                                                           \
+                ih0 = oh * S - P;                                                                                       \
+                if (oh >= CONV_IN_LO(S, P) && oh < CONV_IN_HI(IH, KS, S, P))                                            \
+                {                                                                                                       \
+                    name##_row(in[c], out[c][oh], wk, b[c], ih0, 0, KS);                                                \
+                }                                                                                                       \
+                else                                                                                                    \
+                {                                                                                                       \
+                    name##_row(in[c], out[c][oh], wk, b[c], ih0, CONV_TAP_LO(ih0), CONV_TAP_HI(ih0, IH, KS));           \
+                }                                                                                                       \
+            }                                                                                                           \
+        }                                                                                                               \
+    }
+
+
+#ifndef KERNELS_PW_OCB
+#define KERNELS_PW_OCB 4
+#endif
+#ifndef KERNELS_PW_PB
+#define KERNELS_PW_PB 4
+#endif
+// Pointwise (1x1) convolution: a [OC][IC] x [IC][H*W] product. Register tiles of
+// KERNELS_PW_OCB output channels x KERNELS_PW_PB adjacent pixels: per input
+// channel, PB input and OCB weight loads feed OCB*PB accumulators (16 MACs for 8
+// loads with the 4 x 4 default, 24 live registers)
+#define DEFINE_CONV2D_PW(name, ...) DEFINE_CONV2D_PW_(name, __VA_ARGS__)
+#define DEFINE_CONV2D_PW_(name, IC, H, W, OC, EPI)                                                                 \
+    _Static_assert((OC) % KERNELS_PW_OCB == 0, #name ": OC must be a multiple of KERNELS_PW_OCB");                 \
+    _Static_assert((H) * (W) % KERNELS_PW_PB == 0, #name ": H*W must be a multiple of KERNELS_PW_PB");             \
+    __attribute__((unused)) static const layer_desc_t name##_desc = {                                              \
+        #name, IC, H, W, OC, H, W, 1, 1, 0, (epilogue_t)EPI##_EPI};                                                \
+    static void name(const int8_t in[IC][H][W], int8_t out[OC][H][W], const int8_t w[OC][IC], const int32_t b[OC]) \
+    {                                                                                                              \
+        const int8_t *x;                                                                                           \
+        int32_t acc[KERNELS_PW_OCB][KERNELS_PW_PB], xv[KERNELS_PW_PB], wv[KERNELS_PW_OCB];                         \
+        for (int oc = 0; oc < (OC); oc += KERNELS_PW_OCB)                                                          \
+        {                                                                                                          \
+            for (int p = 0; p < (H) * (W); p += KERNELS_PW_PB)                                                     \
+            {                                                                                                      \
+                KERNELS_UNROLL(KERNELS_PW_OCB)                                                                     \
+                for (int j = 0; j < KERNELS_PW_OCB; j++)                                                           \
+                {                                                                                                  \
+                    KERNELS_UNROLL(KERNELS_PW_PB)                                                                  \
+                    for (int i = 0; i < KERNELS_PW_PB; i++)                                                        \
+                    {                                                                                              \
+                        acc[j][i] = b[oc + j];                                                                     \
+                    }                                                                                              \
+                }                                                                                                  \
+                x = &in[0][0][0] + p;                                                                              \
+                for (int ic = 0; ic < (IC); ic++, x += (H) * (W))                                                  \
+                {                                                                                                  \
+                    KERNELS_UNROLL(KERNELS_PW_PB)                                                                  \
+                    for (int i = 0; i < KERNELS_PW_PB; i++)                                                        \
+                    {                                                                                              \
+                        xv[i] = x[i];                                                                              \
+                    }                                                                                              \
+                    KERNELS_UNROLL(KERNELS_PW_OCB)                                                                 \
+                    for (int j = 0; j < KERNELS_PW_OCB; j++)                                                       \
+                    {                                                                                              \
+                        wv[j] = w[oc + j][ic];                                                                     \
+                    }                                                                                              \
+                    KERNELS_UNROLL(KERNELS_PW_OCB)                                                                 \
+                    for (int j = 0; j < KERNELS_PW_OCB; j++)                                                       \
+                    {                                                                                              \
+                        KERNELS_UNROLL(KERNELS_PW_PB)                                                              \
+                        for (int i = 0; i < KERNELS_PW_PB; i++)                                                    \
+                        {                                                                                          \
+                            acc[j][i] += xv[i] * wv[j];                                                            \
+                        }                                                                                          \
+                    }                                                                                              \
+                }                                                                                                  \
+                KERNELS_UNROLL(KERNELS_PW_OCB)                                                                     \
+                for (int j = 0; j < KERNELS_PW_OCB; j++)                                                           \
+                {                                                                                                  \
+                    KERNELS_UNROLL(KERNELS_PW_PB)                                                                  \
+                    for (int i = 0; i < KERNELS_PW_PB; i++)                                                        \
+                    {                                                                                              \
+                        (&out[oc + j][0][0])[p + i] = EPI(acc[j][i]);                                              \
+                    }                                                                                              \
+                }                                                                                                  \
+            }                                                                                                      \
+        }                                                                                                          \
+    }
+
+// Layout-generic spellings for the network files: CHW by default, channel-last
+// with -DLAYOUT_NHWC.
+//   int8_t x ACT_DIMS(C, H, W);   ACT_AT(x, c, h, w) = v;
+#ifdef LAYOUT_NHWC
+#define ACT_DIMS(C, H, W) [H][W][C]
+#define ACT_AT(t, c, h, w) (t)[h][w][c]
+#define CONV_W_DIMS(OC, IC, KS) [OC][KS][KS][IC]
+#define CONV_W_OCB_DIMS(OC, IC, KS, OCB) [(OC) / (OCB)][KS][KS][IC][OCB]
+#define DEFINE_CONV2D_ACT DEFINE_CONV2D_NHWC
+#define DEFINE_CONV2D_U8_ACT DEFINE_CONV2D_U8_NHWC
+#define DEFINE_SKIP_ADD_RELU_ACT DEFINE_SKIP_ADD_RELU_NHWC
+#define DEFINE_GLOBAL_AVG_POOL_ACT DEFINE_GLOBAL_AVG_POOL_NHWC
+#define DEFINE_CONV2D_OCB_ACT DEFINE_CONV2D_NHWC_OCB
+#define DEFINE_REPACK_OCB_ACT DEFINE_REPACK_OHWI_OCB
+#else
+#define ACT_DIMS(C, H, W) [C][H][W]
+#define ACT_AT(t, c, h, w) (t)[c][h][w]
+#define CONV_W_DIMS(OC, IC, KS) [OC][IC][KS][KS]
+#define CONV_W_OCB_DIMS(OC, IC, KS, OCB) [(OC) / (OCB)][IC][KS][KS][OCB]
+#define DEFINE_CONV2D_ACT DEFINE_CONV2D
+#define DEFINE_CONV2D_U8_ACT DEFINE_CONV2D_U8HWC
+#define DEFINE_SKIP_ADD_RELU_ACT DEFINE_SKIP_ADD_RELU
+#define DEFINE_GLOBAL_AVG_POOL_ACT DEFINE_GLOBAL_AVG_POOL
+#define DEFINE_CONV2D_OCB_ACT DEFINE_CONV2D_OCB
+#define DEFINE_REPACK_OCB_ACT DEFINE_REPACK_OIHW_OCB
+#endif
+
+#endif // RESNET8_KERNELS_H
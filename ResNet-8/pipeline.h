@@ -0,0 +1,183 @@
+// Pipeline-parallel multi-frame execution across harts (QEMU virt -smp N).
+// crt0.s parks harts 1..3 on their own stacks until pipe_run() publishes an
+// entry point in hart_entry; hart S then runs stage S of the network, each
+// stage on a different frame. Frames move between stages through
+// single-producer/single-consumer rings of PIPE_DEPTH activation slots: only
+// the producer writes head, only the consumer writes tail, and a fence orders
+// the slot data against the counter, so no atomics are needed (rv64im).
+//
+// Every stage accounts its own mcycle: busy (computing), wait_in (input ring
+// empty) and wait_out (output ring full). The slowest stage bounds throughput;
+// a stage with large wait_in/wait_out is the one to give more layers. After the
+// run pipe_report() prints
+//
+//   pipe,<name>,stage=S,hart=S,frames=N,busy=..,wait_in=..,wait_out=..
+//   pipe,<name>,stages=S,frames=N,mtime=..,seq_mtime=..,speedup=X.XX,status=E
+//
+// (seq_mtime: the same frames run one after another on hart 0; status 0 = ok,
+// PIPE_ERR_MISMATCH = logits differ from the sequential run, PIPE_ERR_HARTS =
+// fewer than `stages` harts came up) and powers the machine off through the
+// virt test finisher with that status.
+#ifndef RESNET8_PIPELINE_H
+#define RESNET8_PIPELINE_H
+
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifndef PIPE_DEPTH
+#define PIPE_DEPTH 2 // slots per ring: one being filled, one being drained
+#endif
+#define PIPE_MAX_STAGES 4 // hart 0 + the three hart stacks of link.ld
+
+#define PIPE_START_TIMEOUT (PLATFORM_MTIME_HZ / 10) // harts missing after 100 ms: -smp too small
+
+#define PIPE_OK 0
+#define PIPE_ERR_MISMATCH 1
+#define PIPE_ERR_HARTS 2
+
+extern void (*volatile hart_entry)(uint64_t hartid); // crt0.s
+
+// Single-producer/single-consumer ring: the slots live with the caller
+typedef struct
+{
+    volatile uint32_t head; // frames published (producer)
+    volatile uint32_t tail; // frames consumed (consumer)
+} pipe_ring_t;
+
+typedef struct
+{
+    uint64_t busy, wait_in, wait_out;
+    uint32_t frames;
+} pipe_stage_t;
+
+typedef void (*pipe_stage_fn_t)(pipe_stage_t *st);
+
+static inline void pipe_fence(void) { __asm__ volatile("fence rw, rw" ::: "memory"); }
+
+// Producer: slot to fill next, once one is free
+static int pipe_acquire(pipe_ring_t *r, uint64_t *wait)
+{
+    uint64_t c0 = read_mcycle64();
+    while (r->head - r->tail >= PIPE_DEPTH)
+    {
+    }
+    pipe_fence(); // the consumer is done reading the slot
+    *wait += read_mcycle64() - c0;
+    return (int)(r->head % PIPE_DEPTH);
+}
+static void pipe_publish(pipe_ring_t *r)
+{
+    pipe_fence(); // slot data before the new head
+    r->head = r->head + 1;
+}
+
+// Consumer: slot to drain next, once one is published
+static int pipe_peek(pipe_ring_t *r, uint64_t *wait)
+{
+    uint64_t c0 = read_mcycle64();
+    while (r->tail == r->head)
+    {
+    }
+    pipe_fence(); // head before the slot data
+    *wait += read_mcycle64() - c0;
+    return (int)(r->tail % PIPE_DEPTH);
+}
+static void pipe_release(pipe_ring_t *r)
+{
+    pipe_fence(); // slot reads before the new tail
+    r->tail = r->tail + 1;
+}
+
+static const pipe_stage_fn_t *pipe_stages;
+static int pipe_nstages;
+static pipe_stage_t pipe_stat[PIPE_MAX_STAGES];
+static volatile uint32_t pipe_up[PIPE_MAX_STAGES], pipe_done[PIPE_MAX_STAGES];
+
+static void pipe_hart(uint64_t hartid)
+{
+    pipe_fence(); // hart_entry before pipe_stages
+    if (hartid >= (uint64_t)pipe_nstages)
+    {
+        return; // more harts than stages: park
+    }
+    pipe_up[hartid] = 1;
+    pipe_stages[hartid](&pipe_stat[hartid]);
+    pipe_fence();
+    pipe_done[hartid] = 1;
+}
+
+// Runs stages[0] on hart 0 and stages[s] on hart s; returns the elapsed mtime,
+// 0 if a hart did not come up
+static uint64_t pipe_run(const pipe_stage_fn_t *stages, int n)
+{
+    uint64_t m0;
+
+    pipe_stages = stages;
+    pipe_nstages = n;
+    pipe_fence();
+    hart_entry = pipe_hart;
+
+    m0 = read_mtime64();
+    for (int s = 1; s < n; s++)
+    {
+        while (!pipe_up[s])
+        {
+            if (read_mtime64() - m0 > PIPE_START_TIMEOUT)
+            {
+                return 0;
+            }
+        }
+    }
+
+    m0 = read_mtime64();
+    pipe_up[0] = 1;
+    stages[0](&pipe_stat[0]);
+    for (int s = 1; s < n; s++)
+    {
+        while (!pipe_done[s])
+        {
+        }
+    }
+    pipe_fence();
+    return read_mtime64() - m0;
+}
+
+// Prints the per-stage and total lines, then exits QEMU with `status`
+static void pipe_report(const char *name, int frames, uint64_t mtime, uint64_t seq_mtime, int status)
+{
+    for (int s = 0; s < pipe_nstages; s++)
+    {
+        platform_puts("pipe,");
+        platform_puts(name);
+        platform_field("stage", s);
+        platform_field("hart", s);
+        platform_field("frames", pipe_stat[s].frames);
+        platform_field("busy", pipe_stat[s].busy);
+        platform_field("wait_in", pipe_stat[s].wait_in);
+        platform_field("wait_out", pipe_stat[s].wait_out);
+        platform_putc('\n');
+    }
+
+    platform_puts("pipe,");
+    platform_puts(name);
+    platform_field("stages", pipe_nstages);
+    platform_field("frames", frames);
+    platform_field("mtime", mtime);
+    platform_field("seq_mtime", seq_mtime);
+    platform_puts(",speedup=");
+    if (mtime)
+    {
+        platform_putfix(seq_mtime * 100 / mtime, 2);
+    }
+    else
+    {
+        platform_puts("0.00");
+    }
+    platform_field("status", status);
+    platform_putc('\n');
+
+    platform_exit(status);
+}
+
+#endif // RESNET8_PIPELINE_H
@@ -0,0 +1,143 @@
+// Bare-metal platform layer shared by the networks and the feature headers
+// (bench.h, sprof.h, footprint.h, tune.h, pipeline.h, dataset.h, sparse.h,
+// serve.h): the QEMU virt devices they use and the UART report printers.
+//
+//   UART      16550 at PLATFORM_UART, polled writes to THR (no FIFO wait: QEMU
+//             never backs up)
+//   CLINT     mtime at PLATFORM_MTIME, PLATFORM_MTIME_HZ ticks per second
+//   counters  read_mcycle64(), read_minstret64(), read_mtime64(): full 64-bit
+//             values on rv64 and rv32 alike
+//   finisher  sifive_test at PLATFORM_FINISHER: platform_exit(status) powers the
+//             machine off and QEMU exits with `status`
+//
+// Report lines are `<tag>,<name>,key=value,...`: platform_field() prints one
+// decimal `,key=value`, platform_putfix() a fixed-point value and platform_rate()
+// an events-per-second field, integer only (no FPU on rv32im/rv64im).
+#ifndef RESNET8_PLATFORM_H
+#define RESNET8_PLATFORM_H
+
+#include <stdint.h>
+
+#define PLATFORM_UART 0x10000000UL // 16550: RBR/THR +0, FCR +2, LSR +5
+#define PLATFORM_MTIME 0x0200BFF8UL // CLINT mtime
+#define PLATFORM_MTIME_HZ 10000000u // virt timebase-frequency
+#define PLATFORM_FINISHER 0x00100000UL // sifive_test
+#define PLATFORM_FINISHER_PASS 0x5555u
+#define PLATFORM_FINISHER_FAIL 0x3333u
+
+// 64-bit counter CSR `csr`. rv32 reads csr##h, csr, csr##h and retries if the
+// high half changed (the low half carried in between), so long runs do not
+// wrap at 2^32.
+#if __riscv_xlen == 32
+#define PLATFORM_DEFINE_CSR64(name, csr)                      \
+    static inline uint64_t name(void)                         \
+    {                                                         \
+        uint32_t hi, lo, hi2;                                 \
+        __asm__ volatile("1: csrr %0, " #csr "h\n"            \
+                         "   csrr %1, " #csr "\n"             \
+                         "   csrr %2, " #csr "h\n"            \
+                         "   bne  %0, %2, 1b"                 \
+                         : "=&r"(hi), "=&r"(lo), "=&r"(hi2)); \
+        return ((uint64_t)hi << 32) | lo;                     \
+    }
+#else
+#define PLATFORM_DEFINE_CSR64(name, csr)              \
+    static inline uint64_t name(void)                 \
+    {                                                 \
+        uint64_t v;                                   \
+        __asm__ volatile("csrr %0, " #csr : "=r"(v)); \
+        return v;                                     \
+    }
+#endif
+PLATFORM_DEFINE_CSR64(read_mcycle64, mcycle)
+PLATFORM_DEFINE_CSR64(read_minstret64, minstret)
+
+// CLINT mtime; rv32 reads the 64-bit register in two word loads: high, low, high again
+static inline uint64_t read_mtime64(void)
+{
+#if __riscv_xlen == 32
+    volatile uint32_t *t = (volatile uint32_t *)PLATFORM_MTIME;
+    uint32_t hi, lo;
+    do
+    {
+        hi = t[1];
+        lo = t[0];
+    } while (hi != t[1]);
+    return ((uint64_t)hi << 32) | lo;
+#else
+    return *(volatile uint64_t *)PLATFORM_MTIME;
+#endif
+}
+
+static inline void platform_putc(char c) { *(volatile uint8_t *)PLATFORM_UART = (uint8_t)c; }
+static void platform_puts(const char *s)
+{
+    while (*s)
+    {
+        platform_putc(*s++);
+    }
+}
+static void platform_putdec(uint64_t x)
+{
+    char buf[20];
+    int n = 0;
+    do
+    {
+        buf[n++] = (char)('0' + x % 10);
+        x /= 10;
+    } while (x);
+    while (n)
+    {
+        platform_putc(buf[--n]);
+    }
+}
+static void platform_field(const char *key, uint64_t v)
+{
+    platform_putc(',');
+    platform_puts(key);
+    platform_putc('=');
+    platform_putdec(v);
+}
+// v / 10^decimals with `decimals` digits after the point
+static void platform_putfix(uint64_t v, int decimals)
+{
+    uint64_t div = 1;
+    for (int i = 0; i < decimals; i++)
+    {
+        div *= 10;
+    }
+    platform_putdec(v / div);
+    platform_putc('.');
+    while (div > 1)
+    {
+        div /= 10;
+        platform_putc((char)('0' + v / div % 10));
+    }
+}
+// ,key=<n events per second over `mtime` ticks> with 3 decimals, inf if no tick elapsed
+static void platform_rate(const char *key, uint64_t n, uint64_t mtime)
+{
+    platform_putc(',');
+    platform_puts(key);
+    platform_putc('=');
+    if (mtime)
+    {
+        platform_putfix(n * PLATFORM_MTIME_HZ * 1000u / mtime, 3);
+    }
+    else
+    {
+        platform_puts("inf");
+    }
+}
+
+// QEMU exits with `status` (0 = pass)
+__attribute__((noreturn)) static void platform_exit(int status)
+{
+    volatile uint32_t *finisher = (volatile uint32_t *)PLATFORM_FINISHER;
+    *finisher = status ? ((uint32_t)status << 16) | PLATFORM_FINISHER_FAIL : PLATFORM_FINISHER_PASS;
+    for (;;)
+    {
+    }
+}
+
+#endif // RESNET8_PLATFORM_H
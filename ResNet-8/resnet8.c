@@ -11,7 +11,23 @@
 #define QSHIFT 8
 #define POOL_SHIFT 10 // average 32*32 = 1024 -> >>10
 #define NUM_CLASSES 10
+#define INPUT_ZP 128 // zero point of the uint8 camera frames (resnet8_u8)
 #define UART_TX 0x10000000UL
+// -DLAYOUT_NHWC: channel-last activations and OHWI conv weights (see kernels.h)
+// -DWEIGHT_BLOCK=4|8: residual convs on oc-blocked weights, repacked in main
+// -DWINOGRAD_IP: residual convs and FC as Winograd inner products (half the multiplies)
+// -DTUNE: conv0 implementation picked at startup by the autotuner (conv0_impls.h)
+// -DDELTA: also build resnet8_delta(), incremental inference on similar frames
+// -DPIPELINE: stream frames through conv0+rb1 / rb2 / rb3+GAP+FC on harts 0/1/2
+// -DCONV_TILED: cache-blocked residual convs, tile sizes from tiling.h (-DL1D_SIZE)
+// -DSPARSE_ACT: residual convs skip zero activations via nonzero bitmaps, density report (sparse.h)
+// -DRB_SEPARABLE: depthwise-separable residual blocks, 3x3 depthwise + 1x1 pointwise convs (~7x fewer MACs)
+// -DDATASET: real weights and test images from the host over semihosting (dataset.h)
+// -DSERVE: classify framed requests from the serial port instead (serve.h, Tools/loadgen.py)
+// rv32imc: link with ../crt0_rv32.s and ../link_rv32.ld (flash/RAM budgets, see README)
+
+#include "kernels.h"
+#include "platform.h"
 
  //UART print
 static inline void uart_putc(char c) { *(volatile uint8_t *)UART_TX = (uint8_t)c; }
@@ -31,323 +47,836 @@ static void uart_puthex64(uint64_t x)
     }
 }
 static inline void uart_nl(void) { uart_putc('\n'); }
-static inline uint64_t rdcycle(void)
-{
-    uint64_t v;
-    __asm__ volatile("csrr %0, mcycle" : "=r"(v));
-    return v;
-}
 
 // Weights & Biases
-static int8_t conv0_w[OUT_C][IN_C][K][K];
+static int8_t conv0_w CONV_W_DIMS(OUT_C, IN_C, K);
 static int32_t conv0_b[OUT_C];
+static int32_t conv0_b_zp[OUT_C]; // conv0_b with INPUT_ZP folded in (resnet8_u8)
 
-static int8_t rb1_w1[OUT_C][OUT_C][K][K], rb1_w2[OUT_C][OUT_C][K][K];
+#ifdef RB_SEPARABLE
+// Each residual conv as a depthwise KxK conv (dw, db) and a pointwise 1x1 conv (pw, pb)
+static int8_t rb1_dw1[OUT_C][K][K], rb1_pw1[OUT_C][OUT_C], rb1_dw2[OUT_C][K][K], rb1_pw2[OUT_C][OUT_C];
+static int32_t rb1_db1[OUT_C], rb1_pb1[OUT_C], rb1_db2[OUT_C], rb1_pb2[OUT_C];
+
+static int8_t rb2_dw1[OUT_C][K][K], rb2_pw1[OUT_C][OUT_C], rb2_dw2[OUT_C][K][K], rb2_pw2[OUT_C][OUT_C];
+static int32_t rb2_db1[OUT_C], rb2_pb1[OUT_C], rb2_db2[OUT_C], rb2_pb2[OUT_C];
+
+static int8_t rb3_dw1[OUT_C][K][K], rb3_pw1[OUT_C][OUT_C], rb3_dw2[OUT_C][K][K], rb3_pw2[OUT_C][OUT_C];
+static int32_t rb3_db1[OUT_C], rb3_pb1[OUT_C], rb3_db2[OUT_C], rb3_pb2[OUT_C];
+#else
+static int8_t rb1_w1 CONV_W_DIMS(OUT_C, OUT_C, K), rb1_w2 CONV_W_DIMS(OUT_C, OUT_C, K);
 static int32_t rb1_b1[OUT_C], rb1_b2[OUT_C];
 
-static int8_t rb2_w1[OUT_C][OUT_C][K][K], rb2_w2[OUT_C][OUT_C][K][K];
+static int8_t rb2_w1 CONV_W_DIMS(OUT_C, OUT_C, K), rb2_w2 CONV_W_DIMS(OUT_C, OUT_C, K);
 static int32_t rb2_b1[OUT_C], rb2_b2[OUT_C];
 
-static int8_t rb3_w1[OUT_C][OUT_C][K][K], rb3_w2[OUT_C][OUT_C][K][K];
+static int8_t rb3_w1 CONV_W_DIMS(OUT_C, OUT_C, K), rb3_w2 CONV_W_DIMS(OUT_C, OUT_C, K);
 static int32_t rb3_b1[OUT_C], rb3_b2[OUT_C];
+#endif
+
+#if defined(WEIGHT_BLOCK) && defined(WINOGRAD_IP)
+#error "WEIGHT_BLOCK and WINOGRAD_IP are alternative residual kernels"
+#endif
+#if defined(CONV_TILED) && (defined(WEIGHT_BLOCK) || defined(WINOGRAD_IP) || defined(LAYOUT_NHWC))
+#error "CONV_TILED is an alternative CHW residual kernel (no WEIGHT_BLOCK, WINOGRAD_IP or LAYOUT_NHWC)"
+#endif
+#if defined(SPARSE_ACT) && (defined(WEIGHT_BLOCK) || defined(WINOGRAD_IP) || defined(CONV_TILED) || defined(LAYOUT_NHWC))
+#error "SPARSE_ACT is an alternative CHW residual kernel (no WEIGHT_BLOCK, WINOGRAD_IP, CONV_TILED or LAYOUT_NHWC)"
+#endif
+#if defined(RB_SEPARABLE) && (defined(WEIGHT_BLOCK) || defined(WINOGRAD_IP) || defined(CONV_TILED) || defined(SPARSE_ACT) || defined(LAYOUT_NHWC) || defined(DELTA))
+#error "RB_SEPARABLE is an alternative CHW residual block (no WEIGHT_BLOCK, WINOGRAD_IP, CONV_TILED, SPARSE_ACT, LAYOUT_NHWC or DELTA)"
+#endif
+#ifdef WEIGHT_BLOCK
+// Residual conv weights as the blocked kernels read them (filled by repack_rb)
+#define RB_W_DIMS CONV_W_OCB_DIMS(OUT_C, OUT_C, K, WEIGHT_BLOCK)
+#define RB_W(w) w##_blk
+#define RB_B(b) b
+static int8_t rb1_w1_blk RB_W_DIMS, rb1_w2_blk RB_W_DIMS;
+static int8_t rb2_w1_blk RB_W_DIMS, rb2_w2_blk RB_W_DIMS;
+static int8_t rb3_w1_blk RB_W_DIMS, rb3_w2_blk RB_W_DIMS;
+#elif defined(WINOGRAD_IP)
+#ifdef LAYOUT_NHWC
+#error "WINOGRAD_IP kernels are CHW"
+#endif
+// Channel-paired residual weights and biases with the weight pairs folded in
+// (filled by wino_pack_rb)
+#define RB_W_DIMS [OUT_C][OUT_C / 2][K][K][2]
+#define RB_W(w) w##_wp
+#define RB_B(b) b##_wino
+static int8_t rb1_w1_wp RB_W_DIMS, rb1_w2_wp RB_W_DIMS;
+static int8_t rb2_w1_wp RB_W_DIMS, rb2_w2_wp RB_W_DIMS;
+static int8_t rb3_w1_wp RB_W_DIMS, rb3_w2_wp RB_W_DIMS;
+static int32_t rb1_b1_wino[OUT_C], rb1_b2_wino[OUT_C];
+static int32_t rb2_b1_wino[OUT_C], rb2_b2_wino[OUT_C];
+static int32_t rb3_b1_wino[OUT_C], rb3_b2_wino[OUT_C];
+#else
+#define RB_W_DIMS CONV_W_DIMS(OUT_C, OUT_C, K)
+#define RB_W(w) w
+#define RB_B(b) b
+#endif
+// Weight/bias arguments of residual_block() for block n
+#ifdef RB_SEPARABLE
+#define RB_PARAMS(n) rb##n##_dw1, rb##n##_db1, rb##n##_pw1, rb##n##_pb1, rb##n##_dw2, rb##n##_db2, rb##n##_pw2, rb##n##_pb2
+#else
+#define RB_PARAMS(n) RB_W(rb##n##_w1), RB_B(rb##n##_b1), RB_W(rb##n##_w2), RB_B(rb##n##_b2)
+#endif
 
 static int8_t fc_w[NUM_CLASSES][OUT_C];
 static int32_t fc_b[NUM_CLASSES];
+#ifdef WINOGRAD_IP
+static int8_t fc_w_wp[NUM_CLASSES][OUT_C / 2][2];
+static int32_t fc_b_wino[NUM_CLASSES];
+#define FC_W fc_w_wp
+#define FC_B fc_b_wino
+#else
+#define FC_W fc_w
+#define FC_B fc_b
+#endif
+
+// Layer shapes: in_c, in_h, in_w, out_c, k, stride, pad
+#define CONV0_SHAPE IN_C, IN_H, IN_W, OUT_C, K, STRIDE, PAD
+#define RB_CONV_SHAPE OUT_C, IN_H, IN_W, OUT_C, K, STRIDE, PAD
+
+// Convolutions
+DEFINE_CONV2D_ACT(conv0, CONV0_SHAPE, relu)
+DEFINE_CONV2D_U8_ACT(conv0_u8, CONV0_SHAPE, relu, INPUT_ZP)
+DEFINE_FOLD_INPUT_ZP(fold_input_zp, OUT_C, IN_C, K) // sum over all taps: layout-independent
+#ifdef TUNE
+#include "conv0_impls.h"
+#else
+#define conv0_impl conv0
+#endif
+#ifdef WEIGHT_BLOCK
+DEFINE_CONV2D_OCB_ACT(conv2d_qrelu_32in, RB_CONV_SHAPE, relu, WEIGHT_BLOCK)
+DEFINE_CONV2D_OCB_ACT(conv2d_qlinear_32in, RB_CONV_SHAPE, quant_clip, WEIGHT_BLOCK)
+DEFINE_REPACK_OCB_ACT(repack_rb, OUT_C, OUT_C, K, WEIGHT_BLOCK)
+#elif defined(WINOGRAD_IP)
+DEFINE_CONV2D_WINO(conv2d_qrelu_32in, RB_CONV_SHAPE, relu)
+DEFINE_CONV2D_WINO(conv2d_qlinear_32in, RB_CONV_SHAPE, quant_clip)
+DEFINE_WINO_PACK_CONV(wino_pack_rb, OUT_C, OUT_C, K)
+#elif defined(CONV_TILED)
+#include "tiling.h"
+DEFINE_CONV2D_TILED(conv2d_qrelu_32in, RB_CONV_SHAPE, relu, CONV_TILE_OC, CONV_TILE_OH, CONV_TILE_IC)
+DEFINE_CONV2D_TILED(conv2d_qlinear_32in, RB_CONV_SHAPE, quant_clip, CONV_TILE_OC, CONV_TILE_OH, CONV_TILE_IC)
+#elif defined(SPARSE_ACT)
+#include "sparse.h"
+DEFINE_CONV2D_SPARSE(conv2d_qrelu_32in, RB_CONV_SHAPE, relu)
+DEFINE_CONV2D_SPARSE(conv2d_qlinear_32in, RB_CONV_SHAPE, quant_clip)
+DEFINE_CONV2D(conv2d_qrelu_32in_dense, RB_CONV_SHAPE, relu) // reference of sparse_run()
+DEFINE_ACT_NZ(act_nz, OUT_C, IN_H, IN_W)                     // conv0 output (any conv0_impl)
+#elif defined(RB_SEPARABLE)
+// Requant shifts of the separable convs. Their sums have K*K (depthwise) and
+// OUT_C (pointwise) terms instead of OUT_C*K*K; 3 and 5 keep the all-ones test
+// weights at the scale of the dense convs, trained models set their own
+#ifndef DW_QSHIFT
+#define DW_QSHIFT 3
+#endif
+#ifndef PW_QSHIFT
+#define PW_QSHIFT 5
+#endif
+DEFINE_EPILOGUES(dw, DW_QSHIFT)
+DEFINE_EPILOGUES(pw, PW_QSHIFT)
+DEFINE_DWCONV2D(dwconv_qrelu_32in, OUT_C, IN_H, IN_W, K, STRIDE, PAD, relu_dw)
+DEFINE_CONV2D_PW(pwconv_qrelu_32in, OUT_C, IN_H, IN_W, OUT_C, relu_pw)
+DEFINE_CONV2D_PW(pwconv_qlinear_32in, OUT_C, IN_H, IN_W, OUT_C, quant_clip_pw)
+#else
+DEFINE_CONV2D_ACT(conv2d_qrelu_32in, RB_CONV_SHAPE, relu)
+DEFINE_CONV2D_ACT(conv2d_qlinear_32in, RB_CONV_SHAPE, quant_clip)
+#endif
+#ifdef SPARSE_ACT
+DEFINE_SKIP_ADD_RELU_NZ(skip_add_relu, OUT_C, IN_H, IN_W)
+#define NZ_DIMS [OUT_C][IN_H] // one bitmap word per channel row
+
+// Density and cycles of the six residual convs, in network order
+#define RB_LAYER(n) {.name = n, .size = OUT_C * IN_H * IN_W}
+static sparse_layer_t rb_layers[6] = {
+    RB_LAYER("rb1_conv1"), RB_LAYER("rb1_conv2"), RB_LAYER("rb2_conv1"),
+    RB_LAYER("rb2_conv2"), RB_LAYER("rb3_conv1"), RB_LAYER("rb3_conv2"),
+};
+
+// Residual Block on nonzero bitmaps: in_nz describes in, out_nz receives the
+// bitmap of out (0 if no conv reads it), st accounts the two convs
+static void residual_block(const int8_t in ACT_DIMS(OUT_C, IN_H, IN_W), const uint32_t in_nz NZ_DIMS, int8_t out ACT_DIMS(OUT_C, IN_H, IN_W), uint32_t out_nz NZ_DIMS,
+                           const int8_t w1 RB_W_DIMS, const int32_t b1[OUT_C], const int8_t w2 RB_W_DIMS, const int32_t b2[OUT_C],
+                           int8_t t1 ACT_DIMS(OUT_C, IN_H, IN_W), int8_t t2 ACT_DIMS(OUT_C, IN_H, IN_W), uint32_t t1_nz NZ_DIMS, sparse_layer_t st[2])
+{
+    uint64_t c0, c1, c2;
+
+    c0 = read_mcycle64();
+    conv2d_qrelu_32in(in, in_nz, t1, t1_nz, w1, b1); // conv + ReLU, bitmap of t1
+    c1 = read_mcycle64();
+    conv2d_qlinear_32in(t1, t1_nz, t2, 0, w2, b2);   // conv + quant (no ReLU)
+    c2 = read_mcycle64();
+
+    // skip add + ReLU (saturation at [0,127]), bitmap of out
+    skip_add_relu(in, t2, out, out_nz);
+
+    sparse_account(&st[0], &in_nz[0][0], OUT_C * IN_H, c1 - c0);
+    sparse_account(&st[1], &t1_nz[0][0], OUT_C * IN_H, c2 - c1);
+}
+#elif defined(RB_SEPARABLE)
+DEFINE_SKIP_ADD_RELU_ACT(skip_add_relu, OUT_C, IN_H, IN_W)
+
+// Depthwise-separable Residual Block: each conv is depthwise + ReLU, then
+// pointwise with the dense conv's epilogue (t1, t2: scratch of the caller)
+static void residual_block(const int8_t in ACT_DIMS(OUT_C, IN_H, IN_W), int8_t out ACT_DIMS(OUT_C, IN_H, IN_W),
+                           const int8_t dw1[OUT_C][K][K], const int32_t db1[OUT_C], const int8_t pw1[OUT_C][OUT_C], const int32_t pb1[OUT_C],
+                           const int8_t dw2[OUT_C][K][K], const int32_t db2[OUT_C], const int8_t pw2[OUT_C][OUT_C], const int32_t pb2[OUT_C],
+                           int8_t t1 ACT_DIMS(OUT_C, IN_H, IN_W), int8_t t2 ACT_DIMS(OUT_C, IN_H, IN_W))
+{
+    dwconv_qrelu_32in(in, t2, dw1, db1);   // depthwise + ReLU
+    pwconv_qrelu_32in(t2, t1, pw1, pb1);   // pointwise + ReLU
+    dwconv_qrelu_32in(t1, t2, dw2, db2);   // depthwise + ReLU
+    pwconv_qlinear_32in(t2, t1, pw2, pb2); // pointwise + quant (no ReLU)
+
+    // skip add + ReLU (saturation at [0,127])
+    skip_add_relu(in, t1, out);
+}
+#else
+DEFINE_SKIP_ADD_RELU_ACT(skip_add_relu, OUT_C, IN_H, IN_W)
+
+// Residual Block (t1, t2: scratch of the caller, so blocks can run on several harts)
+static void residual_block(const int8_t in ACT_DIMS(OUT_C, IN_H, IN_W), int8_t out ACT_DIMS(OUT_C, IN_H, IN_W), const int8_t w1 RB_W_DIMS, const int32_t b1[OUT_C], const int8_t w2 RB_W_DIMS, const int32_t b2[OUT_C],
+                           int8_t t1 ACT_DIMS(OUT_C, IN_H, IN_W), int8_t t2 ACT_DIMS(OUT_C, IN_H, IN_W))
+{
+    conv2d_qrelu_32in(in, t1, w1, b1);   // conv + ReLU
+    conv2d_qlinear_32in(t1, t2, w2, b2); // conv + quant (no ReLU)
+
+    // skip add + ReLU (saturation at [0,127])
+    skip_add_relu(in, t2, out);
+}
+#endif
+
+// Global Average Pooling
+DEFINE_GLOBAL_AVG_POOL_ACT(global_avg_pool, OUT_C, OUT_H, OUT_W, POOL_SHIFT)
+
+// Fully Connected
+#ifdef WINOGRAD_IP
+DEFINE_FC_WINO(fc_qlinear, OUT_C, NUM_CLASSES, quant_clip)
+DEFINE_WINO_PACK_FC(wino_pack_fc, NUM_CLASSES, OUT_C)
+#else
+DEFINE_FC(fc_qlinear, OUT_C, NUM_CLASSES, quant_clip)
+#endif
+
+// Residual blocks, GAP and FC on the conv0 output
+static void resnet8_tail(const int8_t x0 ACT_DIMS(OUT_C, IN_H, IN_W), int8_t out_logits[NUM_CLASSES])
+{
+    static int8_t x1 ACT_DIMS(OUT_C, IN_H, IN_W);
+    static int8_t x2 ACT_DIMS(OUT_C, IN_H, IN_W);
+    static int8_t x3 ACT_DIMS(OUT_C, IN_H, IN_W);
+    static int8_t gap[OUT_C];
+    static int8_t t1 ACT_DIMS(OUT_C, IN_H, IN_W);
+    static int8_t t2 ACT_DIMS(OUT_C, IN_H, IN_W);
+
+    // Residual blocks
+#ifdef SPARSE_ACT
+    static uint32_t nz_a NZ_DIMS, nz_b NZ_DIMS, t1_nz NZ_DIMS;
+
+    act_nz(x0, nz_a);
+    residual_block(x0, nz_a, x1, nz_b, rb1_w1, rb1_b1, rb1_w2, rb1_b2, t1, t2, t1_nz, &rb_layers[0]);
+    residual_block(x1, nz_b, x2, nz_a, rb2_w1, rb2_b1, rb2_w2, rb2_b2, t1, t2, t1_nz, &rb_layers[2]);
+    residual_block(x2, nz_a, x3, 0, rb3_w1, rb3_b1, rb3_w2, rb3_b2, t1, t2, t1_nz, &rb_layers[4]);
+#else
+    residual_block(x0, x1, RB_PARAMS(1), t1, t2);
+    residual_block(x1, x2, RB_PARAMS(2), t1, t2);
+    residual_block(x2, x3, RB_PARAMS(3), t1, t2);
+#endif
+
+    // Global Average Pooling
+    global_avg_pool(x3, gap);
 
-static inline int8_t relu(int32_t acc)
+    // Fully Connected
+    fc_qlinear(gap, out_logits, FC_W, FC_B);
+}
+
+void resnet8(const int8_t input ACT_DIMS(IN_C, IN_H, IN_W), int8_t out_logits[NUM_CLASSES])
 {
-    int32_t q = acc >> QSHIFT;
-    if (q < 0)
+    static int8_t x0 ACT_DIMS(OUT_C, IN_H, IN_W);
+
+    // Conv0
+    conv0_impl(input, x0, conv0_w, conv0_b);
+
+    resnet8_tail(x0, out_logits);
+}
+
+#ifdef DELTA
+#if defined(LAYOUT_NHWC) || defined(WEIGHT_BLOCK) || defined(WINOGRAD_IP)
+#error "DELTA runs the CHW region kernels on OIHW weights"
+#endif
+DEFINE_CONV2D_REGION(conv0_region, CONV0_SHAPE, relu)
+DEFINE_CONV2D_REGION(conv2d_qrelu_32in_region, RB_CONV_SHAPE, relu)
+DEFINE_CONV2D_REGION(conv2d_qlinear_32in_region, RB_CONV_SHAPE, quant_clip)
+DEFINE_DIFF_REGION(diff_input, IN_C, IN_H, IN_W)
+DEFINE_SKIP_ADD_RELU_REGION(skip_add_relu_region, OUT_C, IN_H, IN_W)
+DEFINE_GLOBAL_AVG_POOL_DELTA(global_avg_pool_delta, OUT_C, OUT_H, OUT_W, POOL_SHIFT)
+
+// Every activation of the previous frame, kept between resnet8_delta() calls
+static struct
+{
+    int valid;
+    int8_t input[IN_C][IN_H][IN_W];
+    int8_t x0[OUT_C][IN_H][IN_W];
+    int8_t t1[3][OUT_C][IN_H][IN_W]; // conv1 output of each residual block
+    int8_t x[3][OUT_C][IN_H][IN_W];  // x1..x3
+    int32_t gap_sums[OUT_C];
+    int8_t logits[NUM_CLASSES];
+} delta;
+
+// Dirty region after one 3x3 conv (all convs share shape and padding)
+static region_t grow(const region_t *r) { return region_conv(r, OUT_H, OUT_W, K, STRIDE, PAD); }
+
+// Residual block on the dirty regions r1 (conv1 outputs) and r2 (conv2 and skip add)
+static void residual_block_delta(const int8_t in[OUT_C][IN_H][IN_W], int8_t out[OUT_C][IN_H][IN_W], int8_t t1[OUT_C][IN_H][IN_W],
+                                 const int8_t w1[OUT_C][OUT_C][K][K], const int32_t b1[OUT_C], const int8_t w2[OUT_C][OUT_C][K][K],
+                                 const int32_t b2[OUT_C], const region_t *r1, const region_t *r2)
+{
+    static int8_t t2[OUT_C][IN_H][IN_W]; // only read inside r2, right after it is written
+
+    conv2d_qrelu_32in_region(in, t1, w1, b1, r1);
+    conv2d_qlinear_32in_region(t1, t2, w2, b2, r2);
+    skip_add_relu_region(in, t2, out, r2);
+}
+
+// Incremental resnet8(): the first call computes everything, later calls only
+// the outputs whose receptive field reaches a pixel that changed since the
+// previous call. Same logits as resnet8(). Returns the output positions
+// recomputed over the seven convolutions (7 * OUT_H * OUT_W for a full pass).
+int resnet8_delta(const int8_t input[IN_C][IN_H][IN_W], int8_t out_logits[NUM_CLASSES])
+{
+    static const region_t full = {0, IN_H, 0, IN_W};
+    region_t r0, r1, r2;
+    int8_t gap[OUT_C];
+    int work;
+
+    r0 = diff_input(input, delta.input);
+    if (!delta.valid)
     {
-        q = 0;
+        r0 = full;
+        delta.valid = 1;
     }
-    else if (q > 127)
+    if (region_empty(&r0))
     {
-        q = 127;
+        for (int i = 0; i < NUM_CLASSES; i++)
+        {
+            out_logits[i] = delta.logits[i];
+        }
+        return 0;
     }
 
-    return (int8_t)q;
+    r0 = grow(&r0);
+    conv0_region(input, delta.x0, conv0_w, conv0_b, &r0);
+    work = region_area(&r0);
+
+    r1 = grow(&r0);
+    r2 = grow(&r1);
+    residual_block_delta(delta.x0, delta.x[0], delta.t1[0], rb1_w1, rb1_b1, rb1_w2, rb1_b2, &r1, &r2);
+    work += region_area(&r1) + region_area(&r2);
+
+    r1 = grow(&r2);
+    r2 = grow(&r1);
+    residual_block_delta(delta.x[0], delta.x[1], delta.t1[1], rb2_w1, rb2_b1, rb2_w2, rb2_b2, &r1, &r2);
+    work += region_area(&r1) + region_area(&r2);
+
+    // x3 feeds the GAP: swap the old values of its dirty region out of the sums
+    r1 = grow(&r2);
+    r2 = grow(&r1);
+    global_avg_pool_delta_acc(delta.x[2], delta.gap_sums, &r2, -1);
+    residual_block_delta(delta.x[1], delta.x[2], delta.t1[2], rb3_w1, rb3_b1, rb3_w2, rb3_b2, &r1, &r2);
+    global_avg_pool_delta_acc(delta.x[2], delta.gap_sums, &r2, 1);
+    work += region_area(&r1) + region_area(&r2);
+
+    global_avg_pool_delta(delta.gap_sums, gap);
+    fc_qlinear(gap, delta.logits, fc_w, fc_b);
+    for (int i = 0; i < NUM_CLASSES; i++)
+    {
+        out_logits[i] = delta.logits[i];
+    }
+    return work;
+}
+#endif
+
+// Same network fed with a uint8 interleaved RGB frame: the zero-point shift and
+// the layout change (if any) happen inside conv0 (needs conv0_b_zp, see main)
+void resnet8_u8(const uint8_t frame[IN_H][IN_W][IN_C], int8_t out_logits[NUM_CLASSES])
+{
+    static int8_t x0 ACT_DIMS(OUT_C, IN_H, IN_W);
+
+    conv0_u8(frame, x0, conv0_w, conv0_b_zp);
+
+    resnet8_tail(x0, out_logits);
 }
-static inline int8_t quant_clip(int32_t acc)
+
+// Test weights: all ones, zero bias
+static void fill_ones(int8_t *w, int n_w, int32_t *b, int n_b)
 {
-    int32_t q = acc >> QSHIFT;
-    if (q < -128)
+    for (int i = 0; i < n_w; i++)
     {
-        q = -128;
+        w[i] = 1;
     }
-    else if (q > 127)
+    for (int i = 0; i < n_b; i++)
     {
-        q = 127;
+        b[i] = 0;
     }
-
-    return (int8_t)q;
 }
 
-// Convolutions
-static void conv0(const int8_t in[IN_C][IN_H][IN_W], int8_t out[OUT_C][OUT_H][OUT_W], const int8_t w[OUT_C][IN_C][K][K], const int32_t b[OUT_C])
+static int8_t input ACT_DIMS(IN_C, IN_H, IN_W);
+static uint8_t frame[IN_H][IN_W][IN_C]; // same test values as a uint8 HWC frame
+static int8_t logits[NUM_CLASSES];
+
+#ifdef LAYOUT_NHWC
+#define LAYOUT_NAME "_nhwc"
+#else
+#define LAYOUT_NAME ""
+#endif
+#if defined(WEIGHT_BLOCK) && WEIGHT_BLOCK == 8
+#define LAYOUT_TAG LAYOUT_NAME "_ocb8"
+#elif defined(WEIGHT_BLOCK) && WEIGHT_BLOCK == 4
+#define LAYOUT_TAG LAYOUT_NAME "_ocb4"
+#elif defined(WINOGRAD_IP)
+#define LAYOUT_TAG LAYOUT_NAME "_wino"
+#elif defined(CONV_TILED)
+#define LAYOUT_TAG LAYOUT_NAME "_tiled"
+#elif defined(SPARSE_ACT)
+#define LAYOUT_TAG LAYOUT_NAME "_sparse"
+#elif defined(RB_SEPARABLE)
+#define LAYOUT_TAG LAYOUT_NAME "_dws"
+#else
+#define LAYOUT_TAG LAYOUT_NAME
+#endif
+
+// -DINPUT_U8: time the fused uint8 HWC entry point instead of the int8 one
+#ifdef INPUT_U8
+#define VARIANT "resnet8_u8" LAYOUT_TAG
+static void infer(void) { resnet8_u8(frame, logits); }
+#else
+#define VARIANT "resnet8" LAYOUT_TAG
+static void infer(void) { resnet8(input, logits); }
+#endif
+
+#ifdef SPARSE_ACT
+// Times the dense kernel on rb1's input for the current input and weights (its
+// cost does not depend on the data), checks the sparse kernel and its bitmap
+// against it and prints the per-layer report of every inference so far
+static void sparse_run(const char *name)
 {
-    int32_t acc;
-    int ih, iw;
-    for (int oc = 0; oc < OUT_C; oc++)
+    static int8_t x0[OUT_C][IN_H][IN_W], dense[OUT_C][IN_H][IN_W], sparse[OUT_C][IN_H][IN_W];
+    static uint32_t x0_nz NZ_DIMS, y_nz NZ_DIMS;
+    uint64_t t0, cycles;
+    int match = 1;
+
+    conv0_impl(input, x0, conv0_w, conv0_b);
+    act_nz(x0, x0_nz);
+    t0 = read_mcycle64();
+    conv2d_qrelu_32in_dense(x0, dense, rb1_w1, rb1_b1);
+    cycles = read_mcycle64() - t0;
+    conv2d_qrelu_32in(x0, x0_nz, sparse, y_nz, rb1_w1, rb1_b1);
+    for (int c = 0; c < OUT_C; c++)
     {
-        for (int oh = 0; oh < OUT_H; oh++)
+        for (int h = 0; h < IN_H; h++)
         {
-            for (int ow = 0; ow < OUT_W; ow++)
+            for (int w = 0; w < IN_W; w++)
             {
-                acc = b[oc];
-                for (int ic = 0; ic < IN_C; ic++)
-                {
-                    for (int kh = 0; kh < K; kh++)
-                    {
-                        ih = oh + kh - PAD;
-                        for (int kw = 0; kw < K; kw++)
-                        {
-                            iw = ow + kw - PAD;
-                            if ((unsigned)ih < IN_H && (unsigned)iw < IN_W)
-                            {
-                                acc += (int32_t)in[ic][ih][iw] * (int32_t)w[oc][ic][kh][kw];
-                            }
-                        }
-                    }
-                }
-                out[oc][oh][ow] = relu(acc);
+                match &= sparse[c][h][w] == dense[c][h][w];
+                match &= (int)(y_nz[c][h] >> w & 1) == (dense[c][h][w] != 0);
             }
         }
     }
+    for (int i = 0; i < 6; i++)
+    {
+        rb_layers[i].dense_cycles = cycles; // all six convs have the same shape
+    }
+    sparse_report(name, rb_layers, 6, match);
 }
+#endif
 
-static void conv2d_qrelu_32in(const int8_t in[OUT_C][IN_H][IN_W], int8_t out[OUT_C][OUT_H][OUT_W], const int8_t w[OUT_C][OUT_C][K][K], const int32_t b[OUT_C])
+#if defined(DATASET) || defined(SERVE)
+// One planar uint8 frame into both entry points' inputs
+static void set_input(const uint8_t *px)
 {
-    int32_t acc;
-    int ih, iw;
-    for (int oc = 0; oc < OUT_C; oc++)
+    for (int c = 0; c < IN_C; c++)
     {
-        for (int oh = 0; oh < OUT_H; oh++)
+        for (int h = 0; h < IN_H; h++)
         {
-            for (int ow = 0; ow < OUT_W; ow++)
+            for (int w = 0; w < IN_W; w++)
             {
-                acc = b[oc];
-                for (int ic = 0; ic < OUT_C; ic++)
-                {
-                    for (int kh = 0; kh < K; kh++)
-                    {
-                        ih = oh + kh - PAD;
-                        for (int kw = 0; kw < K; kw++)
-                        {
-                            iw = ow + kw - PAD;
-                            if ((unsigned)ih < IN_H && (unsigned)iw < IN_W)
-                            {
-                                acc += (int32_t)in[ic][ih][iw] * (int32_t)w[oc][ic][kh][kw];
-                            }
-                        }
-                    }
-                }
-                out[oc][oh][ow] = relu(acc);
+                uint8_t v = px[(c * IN_H + h) * IN_W + w];
+                ACT_AT(input, c, h, w) = (int8_t)(v - INPUT_ZP);
+                frame[h][w][c] = v;
             }
         }
     }
 }
+#endif
+
+#ifdef DATASET
+#ifdef SPARSE_ACT
+#define DATASET_REPORT sparse_run // densities of the real images
+#endif
+#include "dataset.h"
 
-static void conv2d_qlinear_32in(const int8_t in[OUT_C][IN_H][IN_W], int8_t out[OUT_C][OUT_H][OUT_W], const int8_t w[OUT_C][OUT_C][K][K], const int32_t b[OUT_C])
+#ifdef RB_SEPARABLE
+// Blob order written by Tools/dataset.py: the conv2d/dwconv2d/fc layers of models/resnet8_dws.json
+#define RB_BLOB(n)                                                          \
+    {rb##n##_dw1, sizeof(rb##n##_dw1)}, {rb##n##_db1, sizeof(rb##n##_db1)}, \
+    {rb##n##_pw1, sizeof(rb##n##_pw1)}, {rb##n##_pb1, sizeof(rb##n##_pb1)}, \
+    {rb##n##_dw2, sizeof(rb##n##_dw2)}, {rb##n##_db2, sizeof(rb##n##_db2)}, \
+    {rb##n##_pw2, sizeof(rb##n##_pw2)}, {rb##n##_pb2, sizeof(rb##n##_pb2)}
+static const dataset_tensor_t weight_blob[] = {
+    {conv0_w, sizeof(conv0_w)}, {conv0_b, sizeof(conv0_b)},
+    RB_BLOB(1), RB_BLOB(2), RB_BLOB(3),
+    {fc_w, sizeof(fc_w)},       {fc_b, sizeof(fc_b)},
+};
+#else
+// Blob order written by Tools/dataset.py: the conv2d/fc layers of models/resnet8.json
+static const dataset_tensor_t weight_blob[] = {
+    {conv0_w, sizeof(conv0_w)}, {conv0_b, sizeof(conv0_b)},
+    {rb1_w1, sizeof(rb1_w1)},   {rb1_b1, sizeof(rb1_b1)},
+    {rb1_w2, sizeof(rb1_w2)},   {rb1_b2, sizeof(rb1_b2)},
+    {rb2_w1, sizeof(rb2_w1)},   {rb2_b1, sizeof(rb2_b1)},
+    {rb2_w2, sizeof(rb2_w2)},   {rb2_b2, sizeof(rb2_b2)},
+    {rb3_w1, sizeof(rb3_w1)},   {rb3_b1, sizeof(rb3_b1)},
+    {rb3_w2, sizeof(rb3_w2)},   {rb3_b2, sizeof(rb3_b2)},
+    {fc_w, sizeof(fc_w)},       {fc_b, sizeof(fc_b)},
+};
+#endif
+
+#ifdef LAYOUT_NHWC
+// The blob is OIHW like the other variants: transpose the conv weights to OHWI
+static void weights_to_ohwi(int8_t *w, int oc, int ic)
 {
-    int32_t acc;
-    int ih, iw;
-    for (int oc = 0; oc < OUT_C; oc++)
+    static int8_t oihw[OUT_C * OUT_C * K * K];
+    for (int i = 0; i < oc * ic * K * K; i++)
     {
-        for (int oh = 0; oh < OUT_H; oh++)
+        oihw[i] = w[i];
+    }
+    for (int o = 0; o < oc; o++)
+    {
+        for (int c = 0; c < ic; c++)
         {
-            for (int ow = 0; ow < OUT_W; ow++)
+            for (int t = 0; t < K * K; t++)
             {
-                acc = b[oc];
-                for (int ic = 0; ic < OUT_C; ic++)
-                {
-                    for (int kh = 0; kh < K; kh++)
-                    {
-                        ih = oh + kh - PAD;
-                        for (int kw = 0; kw < K; kw++)
-                        {
-                            iw = ow + kw - PAD;
-                            if ((unsigned)ih < IN_H && (unsigned)iw < IN_W)
-                            {
-                                acc += (int32_t)in[ic][ih][iw] * (int32_t)w[oc][ic][kh][kw];
-                            }
-                        }
-                    }
-                }
-                out[oc][oh][ow] = quant_clip(acc);
+                w[(o * K * K + t) * ic + c] = oihw[(o * ic + c) * K * K + t];
             }
         }
     }
 }
+#endif
+#endif
+#ifdef SERVE
+#include "serve.h"
+#endif
+#ifdef BENCH
+#include "bench.h"
+#endif
+#ifdef SPROF
+#include "sprof.h"
+#endif
+#ifdef FOOTPRINT
+#include "footprint.h"
+#endif
 
-// Residual Block
-static void residual_block(const int8_t in[OUT_C][IN_H][IN_W], int8_t out[OUT_C][IN_H][IN_W], const int8_t w1[OUT_C][OUT_C][K][K], const int32_t b1[OUT_C], const int8_t w2[OUT_C][OUT_C][K][K], const int32_t b2[OUT_C])
+#ifdef DELTA
+// A short synthetic stream: the test input, the same frame again, then a 4x4
+// patch of one channel changing. Each delta result is checked against resnet8().
+static void delta_stream(void)
 {
-    static int8_t t1[OUT_C][IN_H][IN_W];
-    static int8_t t2[OUT_C][IN_H][IN_W];
-
-    conv2d_qrelu_32in(in, t1, w1, b1);   // conv + ReLU
-    conv2d_qlinear_32in(t1, t2, w2, b2); // conv + quant (no ReLU)
+    static int8_t stream[IN_C][IN_H][IN_W];
+    static int8_t ref[NUM_CLASSES];
+    uint64_t t0, t1;
+    int work, match;
 
-    // skip add + ReLU (saturation at [0,127])
-    for (int c = 0; c < OUT_C; c++)
+    for (int c = 0; c < IN_C; c++)
     {
         for (int h = 0; h < IN_H; h++)
         {
             for (int w = 0; w < IN_W; w++)
             {
-                int32_t s = (int32_t)in[c][h][w] + (int32_t)t2[c][h][w];
-                if (s < 0)
-                {
-                    s = 0;
-                }
-                else if (s > 127)
-                {
-                    s = 127;
-                }
-
-                out[c][h][w] = (int8_t)s;
+                stream[c][h][w] = input[c][h][w];
             }
         }
     }
-}
-
-// Global Average Pooling
-static void global_avg_pool(const int8_t in[OUT_C][IN_H][IN_W], int8_t out_vec[OUT_C])
-{
-    int32_t acc, m;
-    for (int c = 0; c < OUT_C; c++)
+    for (int f = 0; f < 4; f++)
     {
-        acc = 0;
-        for (int h = 0; h < IN_H; h++)
+        if (f >= 2)
         {
-            for (int w = 0; w < IN_W; w++)
+            for (int h = 12; h < 16; h++)
             {
-                acc += (int32_t)in[c][h][w];
+                for (int w = 20; w < 24; w++)
+                {
+                    stream[0][h][w] = (int8_t)(stream[0][h][w] + 9 * f);
+                }
             }
         }
-        m = acc >> POOL_SHIFT;
-        if (m < -128)
+        t0 = read_mcycle64();
+        work = resnet8_delta(stream, logits);
+        t1 = read_mcycle64();
+        resnet8(stream, ref);
+        match = 1;
+        for (int i = 0; i < NUM_CLASSES; i++)
         {
-            m = -128;
+            match &= logits[i] == ref[i];
         }
-        else if (m > 127)
-        {
-            m = 127;
-        }
-        out_vec[c] = (int8_t)m;
+        uart_puts("delta,frame=");
+        uart_putc((char)('0' + f));
+        uart_puts(",work=0x");
+        uart_puthex64((uint64_t)work);
+        uart_puts(",cycles=0x");
+        uart_puthex64(t1 - t0);
+        uart_puts(match ? ",match=ok" : ",match=diff");
+        uart_nl();
     }
 }
+#endif
 
-// Fully Connected
-static void fc_qlinear(const int8_t in_vec[OUT_C], int8_t out_cls[NUM_CLASSES], const int8_t w[NUM_CLASSES][OUT_C], const int32_t b[NUM_CLASSES])
+#ifdef PIPELINE
+#if __riscv_xlen == 32
+#error "PIPELINE needs the multi-hart crt0.s/link.ld layout (rv64)"
+#endif
+#ifdef SPARSE_ACT
+#error "SPARSE_ACT blocks pass nonzero bitmaps along, the pipeline rings do not"
+#endif
+#include "pipeline.h"
+#ifndef PIPE_FRAMES
+#define PIPE_FRAMES 12
+#endif
+
+// Stage 0 (hart 0): conv0 + rb1 -> ring01 -> stage 1 (hart 1): rb2 -> ring12
+// -> stage 2 (hart 2): rb3 + GAP + FC. Each stage has its own scratch, the
+// x1/x2 hand-offs live in the ring slots.
+static int8_t pipe_in[PIPE_FRAMES] ACT_DIMS(IN_C, IN_H, IN_W);
+static int8_t pipe_logits[PIPE_FRAMES][NUM_CLASSES];
+static int8_t seq_logits[PIPE_FRAMES][NUM_CLASSES];
+static int8_t ring01_x1[PIPE_DEPTH] ACT_DIMS(OUT_C, IN_H, IN_W);
+static int8_t ring12_x2[PIPE_DEPTH] ACT_DIMS(OUT_C, IN_H, IN_W);
+static pipe_ring_t ring01, ring12;
+
+static void pipe_stage0(pipe_stage_t *st)
 {
-    int32_t acc;
-    for (int c = 0; c < NUM_CLASSES; c++)
+    static int8_t x0 ACT_DIMS(OUT_C, IN_H, IN_W);
+    static int8_t t1 ACT_DIMS(OUT_C, IN_H, IN_W), t2 ACT_DIMS(OUT_C, IN_H, IN_W);
+    uint64_t c0;
+    int o;
+
+    for (int f = 0; f < PIPE_FRAMES; f++)
     {
-        acc = b[c];
-        for (int k = 0; k < OUT_C; k++)
-        {
-            acc += (int32_t)in_vec[k] * (int32_t)w[c][k];
-        }
-        out_cls[c] = quant_clip(acc);
+        o = pipe_acquire(&ring01, &st->wait_out);
+        c0 = read_mcycle64();
+        conv0_impl(pipe_in[f], x0, conv0_w, conv0_b);
+        residual_block(x0, ring01_x1[o], RB_PARAMS(1), t1, t2);
+        st->busy += read_mcycle64() - c0;
+        pipe_publish(&ring01);
+        st->frames++;
     }
 }
 
-void resnet8(const int8_t input[IN_C][IN_H][IN_W], int8_t out_logits[NUM_CLASSES])
+static void pipe_stage1(pipe_stage_t *st)
 {
-    static int8_t x0[OUT_C][IN_H][IN_W];
-    static int8_t x1[OUT_C][IN_H][IN_W];
-    static int8_t x2[OUT_C][IN_H][IN_W];
-    static int8_t x3[OUT_C][IN_H][IN_W];
-    static int8_t gap[OUT_C];
-
-    // Conv0
-    conv0(input, x0, conv0_w, conv0_b);
-
-    // Residual blocks
-    residual_block(x0, x1, rb1_w1, rb1_b1, rb1_w2, rb1_b2);
-    residual_block(x1, x2, rb2_w1, rb2_b1, rb2_w2, rb2_b2);
-    residual_block(x2, x3, rb3_w1, rb3_b1, rb3_w2, rb3_b2);
+    static int8_t t1 ACT_DIMS(OUT_C, IN_H, IN_W), t2 ACT_DIMS(OUT_C, IN_H, IN_W);
+    uint64_t c0;
+    int i, o;
 
-    // Global Average Pooling
-    global_avg_pool(x3, gap);
-
-    // Fully Connected
-    fc_qlinear(gap, out_logits, fc_w, fc_b);
+    for (int f = 0; f < PIPE_FRAMES; f++)
+    {
+        i = pipe_peek(&ring01, &st->wait_in);
+        o = pipe_acquire(&ring12, &st->wait_out);
+        c0 = read_mcycle64();
+        residual_block(ring01_x1[i], ring12_x2[o], RB_PARAMS(2), t1, t2);
+        st->busy += read_mcycle64() - c0;
+        pipe_release(&ring01);
+        pipe_publish(&ring12);
+        st->frames++;
+    }
 }
 
-int main()
+static void pipe_stage2(pipe_stage_t *st)
 {
-    static int8_t input[IN_C][IN_H][IN_W];
-    static int8_t logits[NUM_CLASSES];
+    static int8_t x3 ACT_DIMS(OUT_C, IN_H, IN_W);
+    static int8_t t1 ACT_DIMS(OUT_C, IN_H, IN_W), t2 ACT_DIMS(OUT_C, IN_H, IN_W);
+    static int8_t gap[OUT_C];
+    uint64_t c0;
+    int i;
 
-    for (int h = 0; h < IN_H; h++) // test values
+    for (int f = 0; f < PIPE_FRAMES; f++)
     {
-        for (int w = 0; w < IN_W; w++)
-        {
-            input[0][h][w] = 1;
-            input[1][h][w] = 2;
-            input[2][h][w] = 3;
-        }
+        i = pipe_peek(&ring12, &st->wait_in);
+        c0 = read_mcycle64();
+        residual_block(ring12_x2[i], x3, RB_PARAMS(3), t1, t2);
+        pipe_release(&ring12);
+        global_avg_pool(x3, gap);
+        fc_qlinear(gap, pipe_logits[f], FC_W, FC_B);
+        st->busy += read_mcycle64() - c0;
+        st->frames++;
     }
+}
+
+static const pipe_stage_fn_t pipe_stage_fns[] = {pipe_stage0, pipe_stage1, pipe_stage2};
+
+// PIPE_FRAMES variations of the test input, run once sequentially on hart 0
+// (reference logits and time) and once through the pipeline; exits QEMU
+static void pipe_stream(void)
+{
+    uint64_t m0, seq_mtime, mtime;
+    int status = PIPE_OK;
 
-    for (int oc = 0; oc < OUT_C; oc++)
+    for (int f = 0; f < PIPE_FRAMES; f++)
     {
-        conv0_b[oc] = 0;
-        for (int ic = 0; ic < IN_C; ic++)
+        for (int c = 0; c < IN_C; c++)
         {
-            for (int kh = 0; kh < K; kh++)
+            for (int h = 0; h < IN_H; h++)
             {
-                for (int kw = 0; kw < K; kw++)
+                for (int w = 0; w < IN_W; w++)
                 {
-                    conv0_w[oc][ic][kh][kw] = 1;
+                    ACT_AT(pipe_in[f], c, h, w) = (int8_t)(ACT_AT(input, c, h, w) + ((h * 7 + w * 3 + c + f * 5) & 15));
                 }
             }
         }
     }
 
-    // Residual blocks: weights=1, bias=0
-    for (int oc = 0; oc < OUT_C; oc++)
+    m0 = read_mtime64();
+    for (int f = 0; f < PIPE_FRAMES; f++)
+    {
+        resnet8(pipe_in[f], seq_logits[f]);
+    }
+    seq_mtime = read_mtime64() - m0;
+
+    mtime = pipe_run(pipe_stage_fns, 3);
+    if (!mtime)
+    {
+        status = PIPE_ERR_HARTS;
+    }
+    else
     {
-        rb1_b1[oc] = rb1_b2[oc] = 0;
-        rb2_b1[oc] = rb2_b2[oc] = 0;
-        rb3_b1[oc] = rb3_b2[oc] = 0;
-        for (int ic = 0; ic < OUT_C; ic++)
+        for (int f = 0; f < PIPE_FRAMES; f++)
         {
-            for (int kh = 0; kh < K; kh++)
+            for (int i = 0; i < NUM_CLASSES; i++)
             {
-                for (int kw = 0; kw < K; kw++)
+                if (pipe_logits[f][i] != seq_logits[f][i])
                 {
-                    rb1_w1[oc][ic][kh][kw] = 1;
-                    rb1_w2[oc][ic][kh][kw] = 1;
-                    rb2_w1[oc][ic][kh][kw] = 1;
-                    rb2_w2[oc][ic][kh][kw] = 1;
-                    rb3_w1[oc][ic][kh][kw] = 1;
-                    rb3_w2[oc][ic][kh][kw] = 1;
+                    status = PIPE_ERR_MISMATCH;
                 }
             }
         }
     }
+    pipe_report(VARIANT, PIPE_FRAMES, mtime, seq_mtime, status);
+}
+#endif
 
-    // FC: weights=1, bias=0
-    for (int c = 0; c < NUM_CLASSES; c++)
+int main()
+{
+    for (int h = 0; h < IN_H; h++) // test values
     {
-        fc_b[c] = 0;
-        for (int k = 0; k < OUT_C; k++)
+        for (int w = 0; w < IN_W; w++)
         {
-            fc_w[c][k] = 1;
+            ACT_AT(input, 0, h, w) = 1;
+            ACT_AT(input, 1, h, w) = 2;
+            ACT_AT(input, 2, h, w) = 3;
+            for (int c = 0; c < IN_C; c++)
+            {
+                frame[h][w][c] = (uint8_t)(ACT_AT(input, c, h, w) + INPUT_ZP);
+            }
         }
     }
 
-    uint64_t t0 = rdcycle();
-    resnet8(input, logits);
-    uint64_t t1 = rdcycle();
+    // Conv0, residual blocks, FC: weights=1, bias=0 (any weight layout)
+    fill_ones(&conv0_w[0][0][0][0], sizeof(conv0_w), conv0_b, OUT_C);
+#ifdef RB_SEPARABLE
+    fill_ones(&rb1_dw1[0][0][0], sizeof(rb1_dw1), rb1_db1, OUT_C);
+    fill_ones(&rb1_pw1[0][0], sizeof(rb1_pw1), rb1_pb1, OUT_C);
+    fill_ones(&rb1_dw2[0][0][0], sizeof(rb1_dw2), rb1_db2, OUT_C);
+    fill_ones(&rb1_pw2[0][0], sizeof(rb1_pw2), rb1_pb2, OUT_C);
+    fill_ones(&rb2_dw1[0][0][0], sizeof(rb2_dw1), rb2_db1, OUT_C);
+    fill_ones(&rb2_pw1[0][0], sizeof(rb2_pw1), rb2_pb1, OUT_C);
+    fill_ones(&rb2_dw2[0][0][0], sizeof(rb2_dw2), rb2_db2, OUT_C);
+    fill_ones(&rb2_pw2[0][0], sizeof(rb2_pw2), rb2_pb2, OUT_C);
+    fill_ones(&rb3_dw1[0][0][0], sizeof(rb3_dw1), rb3_db1, OUT_C);
+    fill_ones(&rb3_pw1[0][0], sizeof(rb3_pw1), rb3_pb1, OUT_C);
+    fill_ones(&rb3_dw2[0][0][0], sizeof(rb3_dw2), rb3_db2, OUT_C);
+    fill_ones(&rb3_pw2[0][0], sizeof(rb3_pw2), rb3_pb2, OUT_C);
+#else
+    fill_ones(&rb1_w1[0][0][0][0], sizeof(rb1_w1), rb1_b1, OUT_C);
+    fill_ones(&rb1_w2[0][0][0][0], sizeof(rb1_w2), rb1_b2, OUT_C);
+    fill_ones(&rb2_w1[0][0][0][0], sizeof(rb2_w1), rb2_b1, OUT_C);
+    fill_ones(&rb2_w2[0][0][0][0], sizeof(rb2_w2), rb2_b2, OUT_C);
+    fill_ones(&rb3_w1[0][0][0][0], sizeof(rb3_w1), rb3_b1, OUT_C);
+    fill_ones(&rb3_w2[0][0][0][0], sizeof(rb3_w2), rb3_b2, OUT_C);
+#endif
+    fill_ones(&fc_w[0][0], sizeof(fc_w), fc_b, NUM_CLASSES);
+
+#ifdef DATASET
+    dataset_load_weights(VARIANT, weight_blob, (int)(sizeof(weight_blob) / sizeof(weight_blob[0])));
+#ifdef LAYOUT_NHWC
+    weights_to_ohwi(&conv0_w[0][0][0][0], OUT_C, IN_C);
+    weights_to_ohwi(&rb1_w1[0][0][0][0], OUT_C, OUT_C);
+    weights_to_ohwi(&rb1_w2[0][0][0][0], OUT_C, OUT_C);
+    weights_to_ohwi(&rb2_w1[0][0][0][0], OUT_C, OUT_C);
+    weights_to_ohwi(&rb2_w2[0][0][0][0], OUT_C, OUT_C);
+    weights_to_ohwi(&rb3_w1[0][0][0][0], OUT_C, OUT_C);
+    weights_to_ohwi(&rb3_w2[0][0][0][0], OUT_C, OUT_C);
+#endif
+#endif
+
+    // Zero point folded into the conv0 bias once, at weight-load time
+    fold_input_zp(conv0_w, conv0_b, INPUT_ZP, conv0_b_zp);
 
-    uart_puts("resnet8 cycles: 0x");
+#ifdef WEIGHT_BLOCK
+    // Residual weights interleaved in groups of WEIGHT_BLOCK output channels
+    repack_rb(rb1_w1, rb1_w1_blk);
+    repack_rb(rb1_w2, rb1_w2_blk);
+    repack_rb(rb2_w1, rb2_w1_blk);
+    repack_rb(rb2_w2, rb2_w2_blk);
+    repack_rb(rb3_w1, rb3_w1_blk);
+    repack_rb(rb3_w2, rb3_w2_blk);
+#endif
+#ifdef WINOGRAD_IP
+    // Weight pairs swapped into place and their products folded into the biases
+    wino_pack_rb(rb1_w1, rb1_b1, rb1_w1_wp, rb1_b1_wino);
+    wino_pack_rb(rb1_w2, rb1_b2, rb1_w2_wp, rb1_b2_wino);
+    wino_pack_rb(rb2_w1, rb2_b1, rb2_w1_wp, rb2_b1_wino);
+    wino_pack_rb(rb2_w2, rb2_b2, rb2_w2_wp, rb2_b2_wino);
+    wino_pack_rb(rb3_w1, rb3_b1, rb3_w1_wp, rb3_b1_wino);
+    wino_pack_rb(rb3_w2, rb3_b2, rb3_w2_wp, rb3_b2_wino);
+    wino_pack_fc(fc_w, fc_b, fc_w_wp, fc_b_wino);
+#endif
+
+#ifdef TUNE
+    // Bind the fastest conv0 that matches the C reference on the loaded weights
+    conv0_tune(conv0_w, conv0_b);
+#endif
+
+#ifdef PIPELINE
+    pipe_stream();
+#endif
+#ifdef SERVE
+    serve_run(VARIANT, set_input, infer, logits, NUM_CLASSES); // with -DDATASET: its weights, images from the UART
+#endif
+#ifdef DATASET
+    dataset_run(VARIANT, set_input, infer, logits, NUM_CLASSES);
+#endif
+#ifdef SPROF
+    sprof_run(VARIANT, infer);
+#endif
+#ifdef BENCH
+    bench_run(VARIANT, infer, logits, NUM_CLASSES);
+#endif
+
+    uint64_t t0 = read_mcycle64();
+    infer();
+    uint64_t t1 = read_mcycle64();
+
+    uart_puts(VARIANT " cycles: 0x");
     uart_puthex64(t1 - t0);
     uart_nl();
 
+#ifdef DELTA
+    delta_stream();
+#endif
+#ifdef SPARSE_ACT
+    sparse_run(VARIANT);
+#endif
+#ifdef FOOTPRINT
+    footprint_report(VARIANT);
+#endif
+
     for (;;)
     {
     }
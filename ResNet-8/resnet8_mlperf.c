@@ -0,0 +1,240 @@
+#include <stdint.h>
+// ResNet-8 with the MLPerf Tiny image-classification topology:
+//   conv0 3->16 (32x32)
+//   stack1: 16->16, stride 1, identity shortcut         (32x32)
+//   stack2: 16->32, stride 2, 1x1 stride-2 projection    (16x16)
+//   stack3: 32->64, stride 2, 1x1 stride-2 projection    (8x8)
+//   GAP 8x8 -> 64, FC 64->10
+// ~12.5 M MACs per inference (resnet8.c: ~57 M).
+// Padding follows the Keras padding='same' of the reference model: 1 on every
+// side for the stride-1 3x3 convs; for the stride-2 3x3 convs on even inputs, 0
+// before and 1 after (output i reads input rows/cols 2i..2i+2).
+#define IN_H 32
+#define IN_W 32
+#define IN_C 3
+#define K 3
+#define PAD 1
+#define PAD_S2 0, 1 // stride-2 3x3: leading, trailing
+#define C1 16 // stack1 channels, 32x32
+#define C2 32 // stack2 channels, 16x16
+#define C3 64 // stack3 channels, 8x8
+#define H1 32
+#define W1 32
+#define H2 16
+#define W2 16
+#define H3 8
+#define W3 8
+#define QSHIFT 8
+#define POOL_SHIFT 6 // average 8*8 = 64 -> >>6
+#define NUM_CLASSES 10
+#define UART_TX 0x10000000UL
+
+#include "kernels.h"
+#include "platform.h"
+
+ //UART print
+static inline void uart_putc(char c) { *(volatile uint8_t *)UART_TX = (uint8_t)c; }
+static void uart_puts(const char *s)
+{
+    while (*s)
+    {
+        uart_putc(*s++);
+    }
+}
+static void uart_puthex64(uint64_t x)
+{
+    static const char H[] = "0123456789ABCDEF";
+    for (int i = 15; i >= 0; i--)
+    {
+        uart_putc(H[(x >> (i * 4)) & 0xF]);
+    }
+}
+static inline void uart_nl(void) { uart_putc('\n'); }
+
+// Weights & Biases
+static int8_t conv0_w[C1][IN_C][K][K];
+static int32_t conv0_b[C1];
+
+static int8_t rb1_w1[C1][C1][K][K], rb1_w2[C1][C1][K][K];
+static int32_t rb1_b1[C1], rb1_b2[C1];
+
+static int8_t rb2_w1[C2][C1][K][K], rb2_w2[C2][C2][K][K], rb2_ws[C2][C1][1][1];
+static int32_t rb2_b1[C2], rb2_b2[C2], rb2_bs[C2];
+
+static int8_t rb3_w1[C3][C2][K][K], rb3_w2[C3][C3][K][K], rb3_ws[C3][C2][1][1];
+static int32_t rb3_b1[C3], rb3_b2[C3], rb3_bs[C3];
+
+static int8_t fc_w[NUM_CLASSES][C3];
+static int32_t fc_b[NUM_CLASSES];
+
+// Layer shapes: in_c, in_h, in_w, out_c, k, stride, pad (pad_lo, pad_hi for DEFINE_CONV2D_PAD)
+#define CONV0_SHAPE IN_C, IN_H, IN_W, C1, K, 1, PAD
+#define RB1_CONV_SHAPE C1, H1, W1, C1, K, 1, PAD
+#define RB2_CONV1_SHAPE C1, H1, W1, C2, K, 2, PAD_S2 // downsampling
+#define RB2_CONV2_SHAPE C2, H2, W2, C2, K, 1, PAD
+#define RB2_PROJ_SHAPE C1, H1, W1, C2, 1, 2, 0       // 1x1 shortcut
+#define RB3_CONV1_SHAPE C2, H2, W2, C3, K, 2, PAD_S2
+#define RB3_CONV2_SHAPE C3, H3, W3, C3, K, 1, PAD
+#define RB3_PROJ_SHAPE C2, H2, W2, C3, 1, 2, 0
+
+// Convolutions
+DEFINE_CONV2D(conv0, CONV0_SHAPE, relu)
+DEFINE_CONV2D(conv2d_qrelu_16in, RB1_CONV_SHAPE, relu)
+DEFINE_CONV2D(conv2d_qlinear_16in, RB1_CONV_SHAPE, quant_clip)
+DEFINE_CONV2D_PAD(conv2d_qrelu_16in_s2, RB2_CONV1_SHAPE, relu)
+DEFINE_CONV2D(conv2d_qlinear_32in, RB2_CONV2_SHAPE, quant_clip)
+DEFINE_CONV2D(conv1x1_qlinear_16in_s2, RB2_PROJ_SHAPE, quant_clip)
+DEFINE_CONV2D_PAD(conv2d_qrelu_32in_s2, RB3_CONV1_SHAPE, relu)
+DEFINE_CONV2D(conv2d_qlinear_64in, RB3_CONV2_SHAPE, quant_clip)
+DEFINE_CONV2D(conv1x1_qlinear_32in_s2, RB3_PROJ_SHAPE, quant_clip)
+DEFINE_SKIP_ADD_RELU(skip_add_relu_16, C1, H1, W1)
+DEFINE_SKIP_ADD_RELU(skip_add_relu_32, C2, H2, W2)
+DEFINE_SKIP_ADD_RELU(skip_add_relu_64, C3, H3, W3)
+
+// Residual Blocks
+// stack1: identity shortcut
+static void residual_block1(const int8_t in[C1][H1][W1], int8_t out[C1][H1][W1])
+{
+    static int8_t t1[C1][H1][W1];
+    static int8_t t2[C1][H1][W1];
+
+    conv2d_qrelu_16in(in, t1, rb1_w1, rb1_b1);   // conv + ReLU
+    conv2d_qlinear_16in(t1, t2, rb1_w2, rb1_b2); // conv + quant (no ReLU)
+
+    // skip add + ReLU (saturation at [0,127])
+    skip_add_relu_16(in, t2, out);
+}
+
+// stack2: stride-2 conv path, 1x1 stride-2 projection on the skip path
+static void residual_block2(const int8_t in[C1][H1][W1], int8_t out[C2][H2][W2])
+{
+    static int8_t t1[C2][H2][W2];
+    static int8_t t2[C2][H2][W2];
+    static int8_t sc[C2][H2][W2];
+
+    conv2d_qrelu_16in_s2(in, t1, rb2_w1, rb2_b1);
+    conv2d_qlinear_32in(t1, t2, rb2_w2, rb2_b2);
+    conv1x1_qlinear_16in_s2(in, sc, rb2_ws, rb2_bs);
+
+    skip_add_relu_32(sc, t2, out);
+}
+
+// stack3: as stack2, 32 -> 64 channels
+static void residual_block3(const int8_t in[C2][H2][W2], int8_t out[C3][H3][W3])
+{
+    static int8_t t1[C3][H3][W3];
+    static int8_t t2[C3][H3][W3];
+    static int8_t sc[C3][H3][W3];
+
+    conv2d_qrelu_32in_s2(in, t1, rb3_w1, rb3_b1);
+    conv2d_qlinear_64in(t1, t2, rb3_w2, rb3_b2);
+    conv1x1_qlinear_32in_s2(in, sc, rb3_ws, rb3_bs);
+
+    skip_add_relu_64(sc, t2, out);
+}
+
+// Global Average Pooling (downsampled 8x8 map)
+DEFINE_GLOBAL_AVG_POOL(global_avg_pool, C3, H3, W3, POOL_SHIFT)
+
+// Fully Connected
+DEFINE_FC(fc_qlinear, C3, NUM_CLASSES, quant_clip)
+
+void resnet8_mlperf(const int8_t input[IN_C][IN_H][IN_W], int8_t out_logits[NUM_CLASSES])
+{
+    static int8_t x0[C1][H1][W1];
+    static int8_t x1[C1][H1][W1];
+    static int8_t x2[C2][H2][W2];
+    static int8_t x3[C3][H3][W3];
+    static int8_t gap[C3];
+
+    // Conv0
+    conv0(input, x0, conv0_w, conv0_b);
+
+    // Residual blocks
+    residual_block1(x0, x1);
+    residual_block2(x1, x2);
+    residual_block3(x2, x3);
+
+    // Global Average Pooling
+    global_avg_pool(x3, gap);
+
+    // Fully Connected
+    fc_qlinear(gap, out_logits, fc_w, fc_b);
+}
+
+// Test weights: all ones, zero bias
+static void fill_ones(int8_t *w, int n_w, int32_t *b, int n_b)
+{
+    for (int i = 0; i < n_w; i++)
+    {
+        w[i] = 1;
+    }
+    for (int i = 0; i < n_b; i++)
+    {
+        b[i] = 0;
+    }
+}
+
+static int8_t input[IN_C][IN_H][IN_W];
+static int8_t logits[NUM_CLASSES];
+
+#if defined(BENCH) || defined(SPROF)
+static void infer(void) { resnet8_mlperf(input, logits); }
+#endif
+#ifdef BENCH
+#include "bench.h"
+#endif
+#ifdef SPROF
+#include "sprof.h"
+#endif
+#ifdef FOOTPRINT
+#include "footprint.h"
+#endif
+
+int main()
+{
+    for (int h = 0; h < IN_H; h++) // test values
+    {
+        for (int w = 0; w < IN_W; w++)
+        {
+            input[0][h][w] = 1;
+            input[1][h][w] = 2;
+            input[2][h][w] = 3;
+        }
+    }
+
+    fill_ones(&conv0_w[0][0][0][0], sizeof(conv0_w), conv0_b, C1);
+    fill_ones(&rb1_w1[0][0][0][0], sizeof(rb1_w1), rb1_b1, C1);
+    fill_ones(&rb1_w2[0][0][0][0], sizeof(rb1_w2), rb1_b2, C1);
+    fill_ones(&rb2_w1[0][0][0][0], sizeof(rb2_w1), rb2_b1, C2);
+    fill_ones(&rb2_w2[0][0][0][0], sizeof(rb2_w2), rb2_b2, C2);
+    fill_ones(&rb2_ws[0][0][0][0], sizeof(rb2_ws), rb2_bs, C2);
+    fill_ones(&rb3_w1[0][0][0][0], sizeof(rb3_w1), rb3_b1, C3);
+    fill_ones(&rb3_w2[0][0][0][0], sizeof(rb3_w2), rb3_b2, C3);
+    fill_ones(&rb3_ws[0][0][0][0], sizeof(rb3_ws), rb3_bs, C3);
+    fill_ones(&fc_w[0][0], sizeof(fc_w), fc_b, NUM_CLASSES);
+
+#ifdef SPROF
+    sprof_run("resnet8_mlperf", infer);
+#endif
+#ifdef BENCH
+    bench_run("resnet8_mlperf", infer, logits, NUM_CLASSES);
+#endif
+
+    uint64_t t0 = read_mcycle64();
+    resnet8_mlperf(input, logits);
+    uint64_t t1 = read_mcycle64();
+
+    uart_puts("resnet8_mlperf cycles: 0x");
+    uart_puthex64(t1 - t0);
+    uart_nl();
+
+#ifdef FOOTPRINT
+    footprint_report("resnet8_mlperf");
+#endif
+
+    for (;;)
+    {
+    }
+    return 0;
+}
@@ -13,9 +13,14 @@
 #define QSHIFT 8
 #define POOL_SHIFT 10 // average 32*32 = 1024 -> >>10
 #define NUM_CLASSES 10
+#define INPUT_ZP 128 // zero point of the uint8 camera frames (resnet8_u8)
 
 #define UART_TX 0x10000000UL
 
+#include "kernels.h"
+#include "platform.h"
+#include "../Conv0/Strassen/strassen_i8.h" // int8 Strassen operands with carry planes
+
 // UART print
 static inline void uart_putc(char c) { *(volatile uint8_t *)UART_TX = (uint8_t)c; }
 static void uart_puts(const char *s)
@@ -34,15 +39,10 @@ static void uart_puthex64(uint64_t x)
     }
 }
 static inline void uart_nl() { uart_putc('\n'); }
-static inline uint64_t rdcycle()
-{
-    uint64_t v;
-    __asm__ volatile("csrr %0, mcycle" : "=r"(v));
-    return v;
-}
 
 static int8_t conv0_w[OUT_C][IN_C][K][K];
 static int32_t conv0_b[OUT_C];
+static int32_t conv0_b_zp[OUT_C]; // conv0_b with the uint8 input offset folded in (resnet8_u8)
 
 static int8_t rb1_w1[OUT_C][OUT_C][K][K], rb1_w2[OUT_C][OUT_C][K][K];
 static int32_t rb1_b1[OUT_C], rb1_b2[OUT_C];
@@ -56,129 +56,45 @@ static int32_t rb3_b1[OUT_C], rb3_b2[OUT_C];
 static int8_t fc_w[NUM_CLASSES][OUT_C];
 static int32_t fc_b[NUM_CLASSES];
 
-static inline int8_t relu(int32_t acc)
-{
-    int32_t q = acc >> QSHIFT;
-    if (q < 0)
-    {
-        q = 0;
-    }
-    else if (q > 127)
-    {
-        q = 127;
-    }
-
-    return (int8_t)q;
-}
-static inline int8_t quant_clip(int32_t acc)
-{
-    int32_t q = acc >> QSHIFT;
-    if (q < -128)
-    {
-        q = -128;
-    }
-    else if (q > 127)
-    {
-        q = 127;
-    }
-
-    return (int8_t)q;
-}
-
-// Copy/operations on submatrix 16x16
-static void copy16_i8_to_i16(const int8_t *src, int src_ld, int16_t *dst, int dst_ld)
-{
-    for (int i = 0; i < 16; i++)
-    {
-        for (int j = 0; j < 16; j++)
-        {
-            dst[i * dst_ld + j] = (int16_t)src[i * src_ld + j];
-        }
-    }
-}
-static void add16_i16(const int16_t *A, const int16_t *B, int16_t *R, int ld)
-{
-    for (int i = 0; i < 16; i++)
-    {
-        for (int j = 0; j < 16; j++)
-        {
-            R[i * ld + j] = A[i * ld + j] + B[i * ld + j];
-        }
-    }
-}
-static void sub16_i16(const int16_t *A, const int16_t *B, int16_t *R, int ld)
-{
-    for (int i = 0; i < 16; i++)
-    {
-        for (int j = 0; j < 16; j++)
-        {
-            R[i * ld + j] = A[i * ld + j] - B[i * ld + j];
-        }
-    }
-}
-// C = A * B
-static void mm16_i16_i32(const int16_t *A, const int16_t *B, int32_t *C, int ldA, int ldB, int ldC)
-{
-    const int16_t *ar, *bc;
-    int32_t acc;
-    for (int i = 0; i < 16; i++)
-    {
-        ar = A + i * ldA;
-        for (int j = 0; j < 16; j++)
-        {
-            bc = B + j;
-            acc = 0;
-            for (int k = 0; k < 16; k++)
-            {
-                acc += (int32_t)ar[k] * (int32_t)bc[k * ldB];
-            }
-            C[i * ldC + j] = acc;
-        }
-    }
-}
-
 // Strassen 32×32: (int8)x(int8)->int32 Partition in 16x16 blocks and applies the 7 multiplications M1..M7.
 static void strassen_mul(const int8_t A[32][32], const int8_t B[32][32], int32_t C[32][32])
 {
-    static int16_t A11[16][16], A12[16][16], A21[16][16], A22[16][16];
-    static int16_t B11[16][16], B12[16][16], B21[16][16], B22[16][16];
-    static int16_t T1[16][16], T2[16][16];
+    static int8_t T1[16][16], T2[16][16];
+    static uint16_t T1c[16], T2c[16];
     static int32_t M1[16][16], M2[16][16], M3[16][16], M4[16][16], M5[16][16], M6[16][16], M7[16][16];
+    const int8_t *A11 = &A[0][0], *A12 = &A[0][16], *A21 = &A[16][0], *A22 = &A[16][16];
+    const int8_t *B11 = &B[0][0], *B12 = &B[0][16], *B21 = &B[16][0], *B22 = &B[16][16];
 
-    // split
-    copy16_i8_to_i16(&A[0][0], 32, &A11[0][0], 16);
-    copy16_i8_to_i16(&A[0][16], 32, &A12[0][0], 16);
-    copy16_i8_to_i16(&A[16][0], 32, &A21[0][0], 16);
-    copy16_i8_to_i16(&A[16][16], 32, &A22[0][0], 16);
-    copy16_i8_to_i16(&B[0][0], 32, &B11[0][0], 16);
-    copy16_i8_to_i16(&B[0][16], 32, &B12[0][0], 16);
-    copy16_i8_to_i16(&B[16][0], 32, &B21[0][0], 16);
-    copy16_i8_to_i16(&B[16][16], 32, &B22[0][0], 16);
-
-    // M1..M7
-    add16_i16(&A11[0][0], &A22[0][0], &T1[0][0], 16);
-    add16_i16(&B11[0][0], &B22[0][0], &T2[0][0], 16);
-    mm16_i16_i32(&T1[0][0], &T2[0][0], &M1[0][0], 16, 16, 16);
+    // M1 = (A11 + A22)*(B11 + B22)
+    add16_i8(A11, A22, 32, &T1[0][0], T1c);
+    add16_i8(B11, B22, 32, &T2[0][0], T2c);
+    mm16_i8_i32(&T1[0][0], 16, T1c, &T2[0][0], 16, T2c, &M1[0][0], 16);
 
-    add16_i16(&A21[0][0], &A22[0][0], &T1[0][0], 16);
-    mm16_i16_i32(&T1[0][0], &B11[0][0], &M2[0][0], 16, 16, 16);
+    // M2 = (A21 + A22)*B11
+    add16_i8(A21, A22, 32, &T1[0][0], T1c);
+    mm16_i8_i32(&T1[0][0], 16, T1c, B11, 32, 0, &M2[0][0], 16);
 
-    sub16_i16(&B12[0][0], &B22[0][0], &T2[0][0], 16);
-    mm16_i16_i32(&A11[0][0], &T2[0][0], &M3[0][0], 16, 16, 16);
+    // M3 = A11*(B12 - B22)
+    sub16_i8(B12, B22, 32, &T2[0][0], T2c);
+    mm16_i8_i32(A11, 32, 0, &T2[0][0], 16, T2c, &M3[0][0], 16);
 
-    sub16_i16(&B21[0][0], &B11[0][0], &T2[0][0], 16);
-    mm16_i16_i32(&A22[0][0], &T2[0][0], &M4[0][0], 16, 16, 16);
+    // M4 = A22*(B21 - B11)
+    sub16_i8(B21, B11, 32, &T2[0][0], T2c);
+    mm16_i8_i32(A22, 32, 0, &T2[0][0], 16, T2c, &M4[0][0], 16);
 
-    add16_i16(&A11[0][0], &A12[0][0], &T1[0][0], 16);
-    mm16_i16_i32(&T1[0][0], &B22[0][0], &M5[0][0], 16, 16, 16);
+    // M5 = (A11 + A12)*B22
+    add16_i8(A11, A12, 32, &T1[0][0], T1c);
+    mm16_i8_i32(&T1[0][0], 16, T1c, B22, 32, 0, &M5[0][0], 16);
 
-    sub16_i16(&A21[0][0], &A11[0][0], &T1[0][0], 16);
-    add16_i16(&B11[0][0], &B12[0][0], &T2[0][0], 16);
-    mm16_i16_i32(&T1[0][0], &T2[0][0], &M6[0][0], 16, 16, 16);
+    // M6 = (A21 - A11)*(B11 + B12)
+    sub16_i8(A21, A11, 32, &T1[0][0], T1c);
+    add16_i8(B11, B12, 32, &T2[0][0], T2c);
+    mm16_i8_i32(&T1[0][0], 16, T1c, &T2[0][0], 16, T2c, &M6[0][0], 16);
 
-    sub16_i16(&A12[0][0], &A22[0][0], &T1[0][0], 16);
-    add16_i16(&B21[0][0], &B22[0][0], &T2[0][0], 16);
-    mm16_i16_i32(&T1[0][0], &T2[0][0], &M7[0][0], 16, 16, 16);
+    // M7 = (A12 - A22)*(B21 + B22)
+    sub16_i8(A12, A22, 32, &T1[0][0], T1c);
+    add16_i8(B21, B22, 32, &T2[0][0], T2c);
+    mm16_i8_i32(&T1[0][0], 16, T1c, &T2[0][0], 16, T2c, &M7[0][0], 16);
 
     // Combine into C
     for (int i = 0; i < 16; i++)
@@ -249,184 +165,124 @@ static void buildB_conv0(const int8_t input[IN_C][IN_H][IN_W], int tile_base, in
         }
     }
 }
-static void conv0_strassen(const int8_t input[IN_C][IN_H][IN_W], int8_t out[OUT_C][OUT_H][OUT_W])
+// uint8 HWC frame: the packing stores u8 ^ 0x80 = u8 - 128, so the operands stay
+// int8; w * (u8 - ZP) = w * (u8 - 128) - (ZP - 128) * w, the second term being in
+// conv0_b_zp. Padding taps get ZP - 128, i.e. 0 after the zero-point shift.
+static void buildB_conv0_u8(const uint8_t frame[IN_H][IN_W][IN_C], int tile_base, int8_t B[K_PAD][TILE_N])
 {
-    int32_t b, acc;
-    static int8_t A[32][32];
-    static int8_t B[K_PAD][TILE_N];
-    static int32_t C[OUT_C][TILE_N];
-    int lin, oh, ow;
-    buildA_conv0(A);
-
-    for (int tile_base = 0; tile_base < OUT_H * OUT_W; tile_base += TILE_N)
+    int lin, oh, ow, idx, ih, iw;
+    int8_t v;
+    for (int col = 0; col < TILE_N; col++)
     {
-        buildB_conv0(input, tile_base, B);
-        strassen_mul((const int8_t (*)[32])A, (const int8_t (*)[32])B, C);
-
-        for (int oc = 0; oc < OUT_C; oc++)
+        lin = tile_base + col;
+        oh = lin / OUT_W;
+        ow = lin % OUT_W;
+        idx = 0;
+        for (int ic = 0; ic < IN_C; ic++)
         {
-            b = conv0_b[oc];
-            for (int col = 0; col < TILE_N; col++)
+            for (int kh = 0; kh < K; kh++)
             {
-                lin = tile_base + col;
-                oh = lin / OUT_W;
-                ow = lin % OUT_W;
-                acc = C[oc][col] + b;
-                out[oc][oh][ow] = relu(acc);
+                ih = oh + kh - PADDING;
+                for (int kw = 0; kw < K; kw++)
+                {
+                    iw = ow + kw - PADDING;
+                    v = (int8_t)(INPUT_ZP ^ 0x80);
+                    if ((unsigned)ih < IN_H && (unsigned)iw < IN_W)
+                    {
+                        v = (int8_t)(frame[ih][iw][ic] ^ 0x80);
+                    }
+                    B[idx++][col] = v;
+                }
             }
         }
+        for (; idx < K_PAD; idx++)
+        {
+            B[idx][col] = 0;
+        }
     }
 }
-
-// Standard Convolution
-static void conv2d_qrelu_32in(const int8_t in[OUT_C][IN_H][IN_W], int8_t out[OUT_C][OUT_H][OUT_W], const int8_t w[OUT_C][OUT_C][K][K], const int32_t b[OUT_C])
+// bias + ReLU on one 32x32 tile of the GEMM output
+static void conv0_tile_store(const int32_t C[OUT_C][TILE_N], const int32_t bias[OUT_C], int tile_base, int8_t out[OUT_C][OUT_H][OUT_W])
 {
-    int32_t acc;
-    int ih, iw;
+    int32_t b, acc;
+    int lin, oh, ow;
     for (int oc = 0; oc < OUT_C; oc++)
     {
-        for (int oh = 0; oh < OUT_H; oh++)
+        b = bias[oc];
+        for (int col = 0; col < TILE_N; col++)
         {
-            for (int ow = 0; ow < OUT_W; ow++)
-            {
-                acc = b[oc];
-                for (int ic = 0; ic < OUT_C; ic++)
-                {
-                    for (int kh = 0; kh < K; kh++)
-                    {
-                        ih = oh + kh - PADDING;
-                        for (int kw = 0; kw < K; kw++)
-                        {
-                            iw = ow + kw - PADDING;
-                            if ((unsigned)ih < IN_H && (unsigned)iw < IN_W)
-                            {
-                                acc += (int32_t)in[ic][ih][iw] * (int32_t)w[oc][ic][kh][kw];
-                            }
-                        }
-                    }
-                }
-                out[oc][oh][ow] = relu(acc);
-            }
+            lin = tile_base + col;
+            oh = lin / OUT_W;
+            ow = lin % OUT_W;
+            acc = C[oc][col] + b;
+            out[oc][oh][ow] = relu(acc);
         }
     }
 }
+static void conv0_strassen(const int8_t input[IN_C][IN_H][IN_W], int8_t out[OUT_C][OUT_H][OUT_W])
+{
+    static int8_t A[32][32];
+    static int8_t B[K_PAD][TILE_N];
+    static int32_t C[OUT_C][TILE_N];
+    buildA_conv0(A);
 
-static void conv2d_qlinear_32in(const int8_t in[OUT_C][IN_H][IN_W], int8_t out[OUT_C][OUT_H][OUT_W], const int8_t w[OUT_C][OUT_C][K][K], const int32_t b[OUT_C])
+    for (int tile_base = 0; tile_base < OUT_H * OUT_W; tile_base += TILE_N)
+    {
+        buildB_conv0(input, tile_base, B);
+        strassen_mul((const int8_t (*)[32])A, (const int8_t (*)[32])B, C);
+        conv0_tile_store((const int32_t (*)[TILE_N])C, conv0_b, tile_base, out);
+    }
+}
+static void conv0_strassen_u8(const uint8_t frame[IN_H][IN_W][IN_C], int8_t out[OUT_C][OUT_H][OUT_W])
 {
-    int32_t acc;
-    int ih, iw;
-    for (int oc = 0; oc < OUT_C; oc++)
+    static int8_t A[32][32];
+    static int8_t B[K_PAD][TILE_N];
+    static int32_t C[OUT_C][TILE_N];
+    buildA_conv0(A);
+
+    for (int tile_base = 0; tile_base < OUT_H * OUT_W; tile_base += TILE_N)
     {
-        for (int oh = 0; oh < OUT_H; oh++)
-        {
-            for (int ow = 0; ow < OUT_W; ow++)
-            {
-                acc = b[oc];
-                for (int ic = 0; ic < OUT_C; ic++)
-                    for (int kh = 0; kh < K; kh++)
-                    {
-                        ih = oh + kh - PADDING;
-                        for (int kw = 0; kw < K; kw++)
-                        {
-                            iw = ow + kw - PADDING;
-                            if ((unsigned)ih < IN_H && (unsigned)iw < IN_W)
-                            {
-                                acc += (int32_t)in[ic][ih][iw] * (int32_t)w[oc][ic][kh][kw];
-                            }
-                        }
-                    }
-                out[oc][oh][ow] = quant_clip(acc);
-            }
-        }
+        buildB_conv0_u8(frame, tile_base, B);
+        strassen_mul((const int8_t (*)[32])A, (const int8_t (*)[32])B, C);
+        conv0_tile_store((const int32_t (*)[TILE_N])C, conv0_b_zp, tile_base, out);
     }
 }
 
+// Standard Convolution (in_c, in_h, in_w, out_c, k, stride, pad)
+#define RB_CONV_SHAPE OUT_C, IN_H, IN_W, OUT_C, K, STRIDE, PADDING
+DEFINE_CONV2D(conv2d_qrelu_32in, RB_CONV_SHAPE, relu)
+DEFINE_CONV2D(conv2d_qlinear_32in, RB_CONV_SHAPE, quant_clip)
+DEFINE_SKIP_ADD_RELU(skip_add_relu, OUT_C, IN_H, IN_W)
+DEFINE_FOLD_INPUT_ZP(fold_input_zp, OUT_C, IN_C, K)
+
 // Residual block
 static void residual_block(const int8_t in[OUT_C][IN_H][IN_W], int8_t out[OUT_C][IN_H][IN_W], const int8_t w1[OUT_C][OUT_C][K][K],
 const int32_t b1[OUT_C], const int8_t w2[OUT_C][OUT_C][K][K], const int32_t b2[OUT_C])
 {
     static int8_t t1[OUT_C][IN_H][IN_W];
     static int8_t t2[OUT_C][IN_H][IN_W];
-    int32_t s;
 
     conv2d_qrelu_32in(in, t1, w1, b1);
     conv2d_qlinear_32in(t1, t2, w2, b2);
 
     // skip add + ReLU (saturation [0,127])
-    for (int c = 0; c < OUT_C; c++)
-    {
-        for (int h = 0; h < IN_H; h++)
-        {
-            for (int w = 0; w < IN_W; w++)
-            {
-                s = (int32_t)in[c][h][w] + (int32_t)t2[c][h][w];
-                if (s < 0)
-                {
-                    s = 0;
-                }
-                else if (s > 127)
-                {
-                    s = 127;
-                }
-                out[c][h][w] = (int8_t)s;
-            }
-        }
-    }
+    skip_add_relu(in, t2, out);
 }
 
 // GAP
-static void global_avg_pool(const int8_t in[OUT_C][IN_H][IN_W], int8_t out_vec[OUT_C])
-{
-    int32_t acc, m;
-    for (int c = 0; c < OUT_C; c++)
-    {
-        acc = 0;
-        for (int h = 0; h < IN_H; h++)
-        {
-            for (int w = 0; w < IN_W; w++)
-            {
-                acc += (int32_t)in[c][h][w];
-            }
-        }
-        m = acc >> POOL_SHIFT;
-        if (m < -128)
-        {
-            m = -128;
-        }
-        else if (m > 127)
-        {
-            m = 127;
-        }
-        out_vec[c] = (int8_t)m;
-    }
-}
-// FC
-static void fc_qlinear(const int8_t in_vec[OUT_C], int8_t out_cls[NUM_CLASSES], const int8_t w[NUM_CLASSES][OUT_C], const int32_t b[NUM_CLASSES])
-{
-    int32_t acc;
-    for (int c = 0; c < NUM_CLASSES; c++)
-    {
-        acc = b[c];
-        for (int k = 0; k < OUT_C; k++)
-        {
-            acc += (int32_t)in_vec[k] * (int32_t)w[c][k];
-        }
+DEFINE_GLOBAL_AVG_POOL(global_avg_pool, OUT_C, OUT_H, OUT_W, POOL_SHIFT)
 
-        out_cls[c] = quant_clip(acc);
-    }
-}
+// FC
+DEFINE_FC(fc_qlinear, OUT_C, NUM_CLASSES, quant_clip)
 
-void resnet8(const int8_t input[IN_C][IN_H][IN_W], int8_t out_logits[NUM_CLASSES])
+// Residual blocks, GAP and FC on the conv0 output
+static void resnet8_tail(const int8_t x0[OUT_C][IN_H][IN_W], int8_t out_logits[NUM_CLASSES])
 {
-    static int8_t x0[OUT_C][IN_H][IN_W];
     static int8_t x1[OUT_C][IN_H][IN_W];
     static int8_t x2[OUT_C][IN_H][IN_W];
     static int8_t x3[OUT_C][IN_H][IN_W];
     static int8_t gap[OUT_C];
 
-    // Conv0 with strassen
-    conv0_strassen(input, x0);
-
     // 3 residual blocks
     residual_block(x0, x1, rb1_w1, rb1_b1, rb1_w2, rb1_b2);
     residual_block(x1, x2, rb2_w1, rb2_b1, rb2_w2, rb2_b2);
@@ -439,11 +295,83 @@ void resnet8(const int8_t input[IN_C][IN_H][IN_W], int8_t out_logits[NUM_CLASSES
     fc_qlinear(gap, out_logits, fc_w, fc_b);
 }
 
-int main()
+void resnet8(const int8_t input[IN_C][IN_H][IN_W], int8_t out_logits[NUM_CLASSES])
 {
-    static int8_t input[IN_C][IN_H][IN_W];
-    static int8_t logits[NUM_CLASSES];
+    static int8_t x0[OUT_C][IN_H][IN_W];
 
+    // Conv0 with strassen
+    conv0_strassen(input, x0);
+
+    resnet8_tail(x0, out_logits);
+}
+
+// uint8 interleaved RGB frame in, zero point and transpose fused into the B packing
+void resnet8_u8(const uint8_t frame[IN_H][IN_W][IN_C], int8_t out_logits[NUM_CLASSES])
+{
+    static int8_t x0[OUT_C][IN_H][IN_W];
+
+    conv0_strassen_u8(frame, x0);
+
+    resnet8_tail(x0, out_logits);
+}
+
+static int8_t input[IN_C][IN_H][IN_W];
+static uint8_t frame[IN_H][IN_W][IN_C]; // same test values as a uint8 HWC frame
+static int8_t logits[NUM_CLASSES];
+
+// -DINPUT_U8: time the fused uint8 HWC entry point instead of the int8 CHW one
+#ifdef INPUT_U8
+#define VARIANT "resnet8_strassen_u8"
+static void infer(void) { resnet8_u8(frame, logits); }
+#else
+#define VARIANT "resnet8_strassen"
+static void infer(void) { resnet8(input, logits); }
+#endif
+
+#ifdef DATASET
+#include "dataset.h"
+
+// Blob order written by Tools/dataset.py: the conv2d/fc layers of models/resnet8.json
+static const dataset_tensor_t weight_blob[] = {
+    {conv0_w, sizeof(conv0_w)}, {conv0_b, sizeof(conv0_b)},
+    {rb1_w1, sizeof(rb1_w1)},   {rb1_b1, sizeof(rb1_b1)},
+    {rb1_w2, sizeof(rb1_w2)},   {rb1_b2, sizeof(rb1_b2)},
+    {rb2_w1, sizeof(rb2_w1)},   {rb2_b1, sizeof(rb2_b1)},
+    {rb2_w2, sizeof(rb2_w2)},   {rb2_b2, sizeof(rb2_b2)},
+    {rb3_w1, sizeof(rb3_w1)},   {rb3_b1, sizeof(rb3_b1)},
+    {rb3_w2, sizeof(rb3_w2)},   {rb3_b2, sizeof(rb3_b2)},
+    {fc_w, sizeof(fc_w)},       {fc_b, sizeof(fc_b)},
+};
+
+// One planar uint8 frame into both entry points' inputs
+static void set_input(const uint8_t *px)
+{
+    for (int c = 0; c < IN_C; c++)
+    {
+        for (int h = 0; h < IN_H; h++)
+        {
+            for (int w = 0; w < IN_W; w++)
+            {
+                uint8_t v = px[(c * IN_H + h) * IN_W + w];
+                input[c][h][w] = (int8_t)(v - INPUT_ZP);
+                frame[h][w][c] = v;
+            }
+        }
+    }
+}
+#endif
+#ifdef BENCH
+#include "bench.h"
+#endif
+#ifdef SPROF
+#include "sprof.h"
+#endif
+#ifdef FOOTPRINT
+#include "footprint.h"
+#endif
+
+int main()
+{
     for (int h = 0; h < IN_H; h++)
     { // test values
         for (int w = 0; w < IN_W; w++)
@@ -451,6 +379,10 @@ int main()
             input[0][h][w] = 1;
             input[1][h][w] = 2;
             input[2][h][w] = 3;
+            for (int c = 0; c < IN_C; c++)
+            {
+                frame[h][w][c] = (uint8_t)(input[c][h][w] + INPUT_ZP);
+            }
         }
     }
     // Conv0: weights=1, bias=0
@@ -502,14 +434,35 @@ int main()
         }
     }
 
-    uint64_t t0 = rdcycle();
-    resnet8(input, logits);
-    uint64_t t1 = rdcycle();
+#ifdef DATASET
+    dataset_load_weights(VARIANT, weight_blob, (int)(sizeof(weight_blob) / sizeof(weight_blob[0])));
+#endif
+
+    // The B packing stores u8 - 128, so the folded offset is INPUT_ZP - 128
+    fold_input_zp(conv0_w, conv0_b, INPUT_ZP - 128, conv0_b_zp);
 
-    uart_puts("resnet8_strassen cycles: 0x");
+#ifdef DATASET
+    dataset_run(VARIANT, set_input, infer, logits, NUM_CLASSES);
+#endif
+#ifdef SPROF
+    sprof_run(VARIANT, infer);
+#endif
+#ifdef BENCH
+    bench_run(VARIANT, infer, logits, NUM_CLASSES);
+#endif
+
+    uint64_t t0 = read_mcycle64();
+    infer();
+    uint64_t t1 = read_mcycle64();
+
+    uart_puts(VARIANT " cycles: 0x");
     uart_puthex64(t1 - t0);
     uart_nl();
 
+#ifdef FOOTPRINT
+    footprint_report(VARIANT);
+#endif
+
     for (;;)
     {
     }
@@ -0,0 +1,267 @@
+// Request/response inference server on the QEMU virt serial port (-DSERVE).
+// Instead of one hard-coded image, the variant reads framed requests from the
+// 16550 RX, queues them in SERVE_QUEUE slots, runs them in batches and writes
+// one line back per request. Tools/loadgen.py drives it from the host
+// (-serial stdio) and measures requests/s and latency percentiles.
+//
+// Request, host -> target (little-endian):
+//
+//   'R' 'Q' | id u32 | SERVE_FRAME bytes, planar uint8 [3][32][32] | sum u8
+//
+// sum is the id bytes plus the pixel bytes mod 256. A mismatch is answered
+// with status SERVE_ERR_SUM and no inference. Bytes outside a frame are
+// skipped up to the next 'R' 'Q', so a corrupted stream resynchronises. 'Q' 'T'
+// stops the server once the queue is empty. Response, target -> host, in
+// request order:
+//
+//   serve,id=N,status=S,class=C,cyc=..,wait=..,batch=B,logits=l0:l1:..:l9
+//
+// cyc: mcycle of the inference alone. wait: mtime ticks from the last byte of
+// the request to the start of its inference (queueing and batching).
+// batch: the size of the batch the request ran in. The server announces itself
+// with `serve,<name>,ready,queue=Q,batch=B`. On 'Q' 'T' it prints
+//
+//   serve,<name>,requests=N,errors=E,batches=B,cyc_avg=..,wait_avg=..,status=0
+//
+// and powers the machine off through the virt test finisher.
+//
+// A batch starts when SERVE_BATCH requests are queued, or when the oldest has
+// waited SERVE_BATCH_WAIT mtime ticks. The kernels take one image at a time,
+// so batching is a scheduling policy, not a batched kernel: it trades latency
+// against back-to-back runs.
+//
+// RX is polled between inferences. It is read only while a queue slot is free,
+// and QEMU stops reading the host stream while the UART FIFO is full, so no
+// byte is lost. A real UART without flow control must size SERVE_QUEUE for the
+// bursts instead.
+#ifndef RESNET8_SERVE_H
+#define RESNET8_SERVE_H
+
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifndef SERVE_QUEUE
+#define SERVE_QUEUE 8 // request slots (3 KiB each)
+#endif
+#ifndef SERVE_BATCH
+#define SERVE_BATCH 1 // requests per batch, 1 = run each request as soon as it is complete
+#endif
+#ifndef SERVE_BATCH_WAIT
+#define SERVE_BATCH_WAIT 10000u // mtime ticks (1 ms) the oldest request waits for a full batch
+#endif
+_Static_assert(SERVE_BATCH >= 1 && SERVE_BATCH <= SERVE_QUEUE, "SERVE_BATCH must fit the queue");
+
+#define SERVE_FRAME (3 * 32 * 32)
+
+#define SERVE_UART_FCR 2
+#define SERVE_UART_LSR 5
+#define SERVE_FCR_FIFO 0x07 // enable and clear the 16-byte FIFOs
+#define SERVE_LSR_DR 0x01   // receive data ready
+
+#define SERVE_OK 0
+#define SERVE_ERR_SUM 1
+
+// Receiver states
+enum
+{
+    SERVE_RX_SYNC,  // between frames
+    SERVE_RX_R,     // after 'R'
+    SERVE_RX_Q,     // after 'Q'
+    SERVE_RX_ID,    // id bytes
+    SERVE_RX_PIXEL, // frame bytes
+    SERVE_RX_SUM,   // checksum byte
+};
+
+typedef struct
+{
+    uint32_t id;
+    int status;
+    uint64_t arrival; // mtime of the last byte
+    uint8_t px[SERVE_FRAME];
+} serve_slot_t;
+
+static serve_slot_t serve_q[SERVE_QUEUE];
+static int serve_head, serve_count, serve_quit;
+static int serve_state = SERVE_RX_SYNC;
+static uint32_t serve_pos;
+static uint8_t serve_sum;
+
+// One received byte; a completed request takes the slot after the queue tail
+static void serve_rx(uint8_t b)
+{
+    serve_slot_t *s = &serve_q[(serve_head + serve_count) % SERVE_QUEUE];
+
+    switch (serve_state)
+    {
+    case SERVE_RX_SYNC:
+        serve_state = b == 'R' ? SERVE_RX_R : b == 'Q' ? SERVE_RX_Q : SERVE_RX_SYNC;
+        break;
+    case SERVE_RX_R:
+        if (b == 'Q')
+        {
+            s->id = 0;
+            serve_pos = 0;
+            serve_sum = 0;
+            serve_state = SERVE_RX_ID;
+        }
+        else
+        {
+            serve_state = b == 'R' ? SERVE_RX_R : SERVE_RX_SYNC;
+        }
+        break;
+    case SERVE_RX_Q:
+        serve_quit = b == 'T';
+        serve_state = b == 'R' ? SERVE_RX_R : b == 'Q' ? SERVE_RX_Q : SERVE_RX_SYNC;
+        break;
+    case SERVE_RX_ID:
+        s->id |= (uint32_t)b << (8 * serve_pos);
+        serve_sum += b;
+        if (++serve_pos == 4)
+        {
+            serve_pos = 0;
+            serve_state = SERVE_RX_PIXEL;
+        }
+        break;
+    case SERVE_RX_PIXEL:
+        s->px[serve_pos] = b;
+        serve_sum += b;
+        if (++serve_pos == SERVE_FRAME)
+        {
+            serve_state = SERVE_RX_SUM;
+        }
+        break;
+    default: // SERVE_RX_SUM
+        s->status = b == serve_sum ? SERVE_OK : SERVE_ERR_SUM;
+        s->arrival = read_mtime64();
+        serve_count++;
+        serve_state = SERVE_RX_SYNC;
+        break;
+    }
+}
+
+// Drains the RX FIFO while a slot is free (and until 'Q' 'T')
+static void serve_poll(void)
+{
+    volatile uint8_t *uart = (volatile uint8_t *)PLATFORM_UART;
+
+    while (serve_count < SERVE_QUEUE && !serve_quit && (uart[SERVE_UART_LSR] & SERVE_LSR_DR))
+    {
+        serve_rx(uart[0]);
+    }
+}
+
+static void serve_respond(const serve_slot_t *s, const int8_t *logits, int num_classes, uint64_t cyc, uint64_t wait,
+                          int batch)
+{
+    int best = 0;
+
+    for (int i = 1; i < num_classes; i++)
+    {
+        if (logits[i] > logits[best])
+        {
+            best = i;
+        }
+    }
+    platform_puts("serve");
+    platform_field("id", s->id);
+    platform_field("status", (uint64_t)s->status);
+    platform_field("class", s->status == SERVE_OK ? (uint64_t)best : 0);
+    platform_field("cyc", cyc);
+    platform_field("wait", wait);
+    platform_field("batch", (uint64_t)batch);
+    platform_puts(",logits=");
+    for (int i = 0; i < num_classes; i++)
+    {
+        int v = s->status == SERVE_OK ? logits[i] : 0;
+        if (i)
+        {
+            platform_putc(':');
+        }
+        if (v < 0)
+        {
+            platform_putc('-');
+            v = -v;
+        }
+        platform_putdec((uint64_t)v);
+    }
+    platform_putc('\n');
+}
+
+// Serves requests until 'Q' 'T': set_input(px) loads one planar uint8 frame into
+// the variant's input buffers, infer() writes the logits. Prints the summary and exits.
+static void serve_run(const char *name, void (*set_input)(const uint8_t *frame), void (*infer)(void),
+                      const int8_t *logits, int num_classes)
+{
+    volatile uint8_t *uart = (volatile uint8_t *)PLATFORM_UART;
+    uint64_t cyc_sum = 0, wait_sum = 0, requests = 0, errors = 0, batches = 0, cyc, wait, m0;
+    int batch;
+
+    uart[SERVE_UART_FCR] = SERVE_FCR_FIFO;
+    platform_puts("serve,");
+    platform_puts(name);
+    platform_puts(",ready");
+    platform_field("queue", SERVE_QUEUE);
+    platform_field("batch", SERVE_BATCH);
+    platform_putc('\n');
+
+    for (;;)
+    {
+        serve_poll();
+        if (!serve_count)
+        {
+            if (serve_quit)
+            {
+                break;
+            }
+            continue;
+        }
+        // Hold a partial batch while more requests can still join it in time
+        if (serve_count < SERVE_BATCH && !serve_quit && read_mtime64() - serve_q[serve_head].arrival < SERVE_BATCH_WAIT)
+        {
+            continue;
+        }
+
+        batch = serve_count < SERVE_BATCH ? serve_count : SERVE_BATCH;
+        for (int i = 0; i < batch; i++)
+        {
+            const serve_slot_t *s = &serve_q[serve_head];
+            m0 = read_mtime64();
+            wait = m0 - s->arrival;
+            cyc = 0;
+            if (s->status == SERVE_OK)
+            {
+                set_input(s->px);
+                cyc = read_mcycle64();
+                infer();
+                cyc = read_mcycle64() - cyc;
+            }
+            else
+            {
+                errors++;
+            }
+            serve_respond(s, logits, num_classes, cyc, wait, batch);
+            cyc_sum += cyc;
+            wait_sum += wait;
+            requests++;
+            serve_head = (serve_head + 1) % SERVE_QUEUE;
+            serve_count--;
+            serve_poll(); // keep the host stream moving between the inferences of a batch
+        }
+        batches++;
+    }
+
+    platform_puts("serve,");
+    platform_puts(name);
+    platform_field("requests", requests);
+    platform_field("errors", errors);
+    platform_field("batches", batches);
+    platform_field("cyc_avg", requests > errors ? cyc_sum / (requests - errors) : 0);
+    platform_field("wait_avg", requests ? wait_sum / requests : 0);
+    platform_field("status", SERVE_OK);
+    platform_putc('\n');
+
+    platform_exit(SERVE_OK);
+}
+
+#endif // RESNET8_SERVE_H
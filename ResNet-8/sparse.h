@@ -0,0 +1,97 @@
+// Activation density and zero-skipping speedup per layer (-DSPARSE_ACT).
+// The network calls sparse_account() after every sparse convolution
+// (DEFINE_CONV2D_SPARSE) with the nonzero bitmap of its input and the mcycle
+// it took. The caller times the dense kernel of each layer into dense_cycles
+// (data-independent, so once is enough). sparse_report() then prints
+//
+//   sparse,<name>,layer=<layer>,runs=N,density=XX.XX,cyc_avg=..,dense_cyc=..,speedup=X.XX
+//   sparse,<name>,layers=L,density=XX.XX,cyc_avg=..,dense_cyc=..,speedup=X.XX,match=ok|diff
+//
+// density: percent of nonzero input activations over all runs; cyc_avg: mean
+// cycles of the sparse kernel per run; speedup: dense_cyc / cyc_avg. The last
+// line sums the layers of one inference; match reports whether the caller found
+// the sparse outputs equal to the dense ones.
+#ifndef RESNET8_SPARSE_H
+#define RESNET8_SPARSE_H
+
+#include <stdint.h>
+
+#include "platform.h"
+
+typedef struct
+{
+    const char *name;
+    uint32_t size;         // input activations per run
+    uint64_t runs;
+    uint64_t nz;           // nonzero inputs, summed over the runs
+    uint64_t cycles;       // sparse kernel, summed over the runs
+    uint64_t dense_cycles; // one run of the dense kernel
+} sparse_layer_t;
+
+// Set bits of x (SWAR, 32-bit registers only)
+static inline uint32_t sparse_popcount(uint32_t x)
+{
+    x = x - ((x >> 1) & 0x55555555u);
+    x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+    x = (x + (x >> 4)) & 0x0F0F0F0Fu;
+    return (x * 0x01010101u) >> 24;
+}
+
+// One run of a layer: the nonzero bitmap of its input (words uint32_t) and its cycles
+static void sparse_account(sparse_layer_t *l, const uint32_t *nz, int words, uint64_t cycles)
+{
+    uint64_t n = 0;
+    for (int i = 0; i < words; i++)
+    {
+        n += sparse_popcount(nz[i]);
+    }
+    l->runs++;
+    l->nz += n;
+    l->cycles += cycles;
+}
+
+// num / den with 2 decimals
+static void sparse_fixfield(const char *key, uint64_t num, uint64_t den)
+{
+    platform_putc(',');
+    platform_puts(key);
+    platform_putc('=');
+    platform_putfix(den ? num * 100 / den : 0, 2);
+}
+
+static void sparse_report(const char *name, const sparse_layer_t *layers, int n, int match)
+{
+    uint64_t nz = 0, size = 0, cyc = 0, dense = 0, avg;
+
+    for (int i = 0; i < n; i++)
+    {
+        const sparse_layer_t *l = &layers[i];
+        avg = l->runs ? l->cycles / l->runs : 0;
+        platform_puts("sparse,");
+        platform_puts(name);
+        platform_puts(",layer=");
+        platform_puts(l->name);
+        platform_field("runs", l->runs);
+        sparse_fixfield("density", l->nz * 100, l->runs * l->size);
+        platform_field("cyc_avg", avg);
+        platform_field("dense_cyc", l->dense_cycles);
+        sparse_fixfield("speedup", l->dense_cycles, avg);
+        platform_putc('\n');
+        nz += l->runs ? l->nz / l->runs : 0;
+        size += l->size;
+        cyc += avg;
+        dense += l->dense_cycles;
+    }
+
+    platform_puts("sparse,");
+    platform_puts(name);
+    platform_field("layers", n);
+    sparse_fixfield("density", nz * 100, size);
+    platform_field("cyc_avg", cyc);
+    platform_field("dense_cyc", dense);
+    sparse_fixfield("speedup", dense, cyc);
+    platform_puts(match ? ",match=ok" : ",match=diff");
+    platform_putc('\n');
+}
+
+#endif // RESNET8_SPARSE_H
@@ -0,0 +1,174 @@
+// Timer-interrupt sampling profiler for the bare-metal variants (QEMU virt or
+// any hart with a CLINT). Build a variant with -DSPROF and its main() runs
+//
+//   SPROF_ITERS inferences with the machine timer firing every SPROF_PERIOD
+//   mtime ticks; each interrupt bumps the histogram bucket of the interrupted
+//   pc (mepc >> SPROF_SHIFT, relative to _text_start from link.ld),
+//
+// then dumps the non-empty buckets over the UART
+//
+//   sprof,begin,<name>,iters=N,period=P,shift=S,samples=..,dropped=..
+//   sprof,<bucket address, hex>,<samples>
+//   sprof,end
+//
+// and powers the machine off through the virt test finisher (status 0).
+// Tools/sprof.py runs the ELF (or reads a captured UART log), resolves the
+// addresses against the ELF symbol table and prints the hot spots.
+//
+// The handler is a leaf: one histogram update and one mtimecmp write per
+// sample, so the overhead is bounded by the rate (10 kHz by default). Any
+// other trap (a fault in the profiled code) stops the machine with status
+// SPROF_ERR_TRAP; mcause/mepc are left in sprof_trap_cause/sprof_trap_epc.
+#ifndef RESNET8_SPROF_H
+#define RESNET8_SPROF_H
+
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifndef SPROF_ITERS
+#define SPROF_ITERS 10
+#endif
+#ifndef SPROF_PERIOD
+#define SPROF_PERIOD 1000 // mtime ticks between samples (10 MHz: 10 kHz)
+#endif
+#ifndef SPROF_SHIFT
+#define SPROF_SHIFT 4 // bucket = 16 bytes of .text
+#endif
+#ifndef SPROF_BUCKETS
+#define SPROF_BUCKETS 4096 // covers 64 KiB of .text with the default shift
+#endif
+
+#define SPROF_MTIMECMP 0x02004000UL // CLINT mtimecmp, hart 0
+#define SPROF_ERR_TRAP 2
+
+#define SPROF_MCAUSE_MTI (((uintptr_t)1 << (8 * sizeof(uintptr_t) - 1)) | 7) // machine timer interrupt
+#define SPROF_MIE_MTIE (1UL << 7)
+#define SPROF_MSTATUS_MIE (1UL << 3)
+
+extern char _text_start[]; // link.ld
+
+static volatile uint32_t sprof_hist[SPROF_BUCKETS];
+static volatile uint64_t sprof_samples, sprof_dropped;
+static volatile uint64_t sprof_trap_cause, sprof_trap_epc;
+
+static void sprof_puthex(uint64_t x)
+{
+    static const char H[] = "0123456789abcdef";
+    int i = 60;
+    platform_puts("0x");
+    while (i > 0 && !(x >> i))
+    {
+        i -= 4;
+    }
+    for (; i >= 0; i -= 4)
+    {
+        platform_putc(H[(x >> i) & 0xF]);
+    }
+}
+
+static inline void sprof_set_mtimecmp(uint64_t t)
+{
+#if __riscv_xlen == 32
+    // No spurious interrupt while the halves are inconsistent: low half to all-ones first
+    volatile uint32_t *c = (volatile uint32_t *)SPROF_MTIMECMP;
+    c[0] = 0xFFFFFFFFu;
+    c[1] = (uint32_t)(t >> 32);
+    c[0] = (uint32_t)t;
+#else
+    *(volatile uint64_t *)SPROF_MTIMECMP = t;
+#endif
+}
+
+// mtvec target (direct mode): GCC saves the registers it uses and returns with mret
+__attribute__((interrupt("machine"), aligned(4))) static void sprof_trap(void)
+{
+    uintptr_t cause, epc, bucket;
+    uint64_t next, now;
+    __asm__ volatile("csrr %0, mcause" : "=r"(cause));
+    __asm__ volatile("csrr %0, mepc" : "=r"(epc));
+    if (cause != SPROF_MCAUSE_MTI)
+    {
+        sprof_trap_cause = cause;
+        sprof_trap_epc = epc;
+        *(volatile uint32_t *)PLATFORM_FINISHER = ((uint32_t)SPROF_ERR_TRAP << 16) | PLATFORM_FINISHER_FAIL; // inline: the handler stays a leaf
+        for (;;)
+        {
+        }
+    }
+
+    bucket = (epc - (uintptr_t)_text_start) >> SPROF_SHIFT;
+    if (bucket < SPROF_BUCKETS)
+    {
+        sprof_hist[bucket]++;
+    }
+    else
+    {
+        sprof_dropped++; // pc outside the covered .text window
+    }
+    sprof_samples++;
+
+    // Next deadline on the fixed grid; if the handler fell behind, skip ahead
+    // instead of taking back-to-back interrupts
+    next = *(volatile uint64_t *)SPROF_MTIMECMP + SPROF_PERIOD;
+    now = read_mtime64();
+    if (next <= now)
+    {
+        next = now + SPROF_PERIOD;
+    }
+    sprof_set_mtimecmp(next);
+}
+
+static void sprof_start(void)
+{
+    __asm__ volatile("csrw mtvec, %0" ::"r"(&sprof_trap));
+    sprof_set_mtimecmp(read_mtime64() + SPROF_PERIOD);
+    __asm__ volatile("csrs mie, %0" ::"r"(SPROF_MIE_MTIE));
+    __asm__ volatile("csrs mstatus, %0" ::"r"(SPROF_MSTATUS_MIE));
+}
+
+static void sprof_stop(void)
+{
+    __asm__ volatile("csrc mstatus, %0" ::"r"(SPROF_MSTATUS_MIE));
+    __asm__ volatile("csrc mie, %0" ::"r"(SPROF_MIE_MTIE));
+    sprof_set_mtimecmp(UINT64_MAX);
+}
+
+static void sprof_dump(const char *name)
+{
+    platform_puts("sprof,begin,");
+    platform_puts(name);
+    platform_field("iters", SPROF_ITERS);
+    platform_field("period", SPROF_PERIOD);
+    platform_field("shift", SPROF_SHIFT);
+    platform_field("samples", sprof_samples);
+    platform_field("dropped", sprof_dropped);
+    platform_putc('\n');
+    for (int i = 0; i < SPROF_BUCKETS; i++)
+    {
+        if (sprof_hist[i])
+        {
+            platform_puts("sprof,");
+            sprof_puthex((uint64_t)(uintptr_t)_text_start + ((uint64_t)i << SPROF_SHIFT));
+            platform_putc(',');
+            platform_putdec(sprof_hist[i]);
+            platform_putc('\n');
+        }
+    }
+    platform_puts("sprof,end\n");
+}
+
+// Profiles SPROF_ITERS calls of `infer`, dumps the histogram and exits
+static void sprof_run(const char *name, void (*infer)(void))
+{
+    sprof_start();
+    for (int i = 0; i < SPROF_ITERS; i++)
+    {
+        infer();
+    }
+    sprof_stop();
+    sprof_dump(name);
+    platform_exit(0);
+}
+
+#endif // RESNET8_SPROF_H
@@ -0,0 +1,57 @@
+// Tile sizes of the cache-blocked residual convolutions (-DCONV_TILED in
+// resnet8.c, DEFINE_CONV2D_TILED in kernels.h) for a target L1 data-cache size.
+// -DL1D_SIZE=<bytes> selects the profile row (default 32 KiB). The rows are the
+// picks of Tools/tile_plan.py for the 32x32x32 3x3 layers on a 4-way cache with
+// 32-byte lines (the 32 KiB row is also the pick for 8-way / 64-byte lines);
+// -DCONV_TILE_OC/OH/IC override a row with the plan for another geometry.
+//
+// Below 64 KiB the untiled CHW kernel thrashes: the 32 channel planes of the
+// input are 1 KiB apart, so the 3 window rows of all channels fall into a few
+// sets. A tile of TIC channels keeps its rows within the ways.
+//
+//   L1D      TOC TOH TIC   line fills per layer, tiled (untiled)
+//   >= 64K     1   8  32    74 KiB  (73 KiB: the whole input stays cached)
+//   >= 32K    32   1   8   163 KiB  (8093 KiB)
+//   >= 16K    32   1   4   175 KiB  (95 MiB)
+//   >=  8K     8   4   1   304 KiB  (95 MiB)
+//   <   8K     4   4   1   580 KiB  (95 MiB)
+#ifndef RESNET8_TILING_H
+#define RESNET8_TILING_H
+
+#ifndef L1D_SIZE
+#define L1D_SIZE 32768
+#endif
+
+#if L1D_SIZE >= 65536
+#define TILING_OC 1
+#define TILING_OH 8
+#define TILING_IC 32
+#elif L1D_SIZE >= 32768
+#define TILING_OC 32
+#define TILING_OH 1
+#define TILING_IC 8
+#elif L1D_SIZE >= 16384
+#define TILING_OC 32
+#define TILING_OH 1
+#define TILING_IC 4
+#elif L1D_SIZE >= 8192
+#define TILING_OC 8
+#define TILING_OH 4
+#define TILING_IC 1
+#else
+#define TILING_OC 4
+#define TILING_OH 4
+#define TILING_IC 1
+#endif
+
+#ifndef CONV_TILE_OC
+#define CONV_TILE_OC TILING_OC
+#endif
+#ifndef CONV_TILE_OH
+#define CONV_TILE_OH TILING_OH
+#endif
+#ifndef CONV_TILE_IC
+#define CONV_TILE_IC TILING_IC
+#endif
+
+#endif // RESNET8_TILING_H
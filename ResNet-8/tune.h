@@ -0,0 +1,133 @@
+// Startup autotuner: binds the fastest of several interchangeable kernels of a
+// layer. tune_pick() runs every linked candidate on the calibration data of the
+// layer, checks its output byte for byte against candidate 0 (the reference),
+// keeps the minimum mcycle count over TUNE_REPS timed runs and prints
+//
+//   tune,<layer>,<candidate>,cyc=..,status=ok|mismatch|absent
+//   plan,<layer>,<winner>
+//
+// A plan line can be fed back at build time (e.g. -DCONV0_PLAN='"asm_v3"'):
+// tune_pick() then binds that candidate without timing anything.
+#ifndef RESNET8_TUNE_H
+#define RESNET8_TUNE_H
+
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifndef TUNE_REPS
+#define TUNE_REPS 3
+#endif
+
+typedef void (*tune_fn_t)(void);
+
+// One implementation of a layer. `fn` is cast back to the layer's own signature
+// by the invoke callback; `needs` is the (weak) symbol that must be linked for
+// the candidate to exist, 0 if it is not.
+typedef struct
+{
+    const char *name;
+    tune_fn_t fn;
+    tune_fn_t needs;
+} tune_cand_t;
+
+static void tune_line(const char *kind, const char *layer, const char *name)
+{
+    platform_puts(kind);
+    platform_putc(',');
+    platform_puts(layer);
+    platform_putc(',');
+    platform_puts(name);
+}
+
+static int tune_streq(const char *a, const char *b)
+{
+    while (*a && *a == *b)
+    {
+        a++;
+        b++;
+    }
+    return *a == *b;
+}
+
+// Returns the index of the bound candidate. invoke(fn) runs one candidate on
+// the calibration buffers, writing out[0..len); ref holds len bytes of scratch.
+// plan: candidate name to bind without timing, or 0 to tune.
+static int tune_pick(const char *layer, const tune_cand_t *cand, int n, void (*invoke)(tune_fn_t fn),
+                     int8_t *out, int8_t *ref, int len, const char *plan)
+{
+    uint64_t best_cyc = UINT64_MAX, cyc, c0;
+    int best = 0, ok;
+
+    if (plan)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            if (cand[i].needs && tune_streq(cand[i].name, plan))
+            {
+                tune_line("plan", layer, cand[i].name);
+                platform_puts(",bound\n");
+                return i;
+            }
+        }
+        tune_line("plan", layer, plan);
+        platform_puts(",unavailable\n"); // not linked: tune instead
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        tune_line("tune", layer, cand[i].name);
+        if (!cand[i].needs)
+        {
+            platform_puts(",cyc=0,status=absent\n");
+            continue;
+        }
+
+        // Poison with the complement of the reference, so an output byte the
+        // candidate does not write can never pass the check
+        for (int j = 0; j < len; j++)
+        {
+            out[j] = (int8_t)(i ? ~ref[j] : 0);
+        }
+        invoke(cand[i].fn);
+        ok = 1;
+        for (int j = 0; j < len; j++)
+        {
+            if (i == 0)
+            {
+                ref[j] = out[j];
+            }
+            else if (out[j] != ref[j])
+            {
+                ok = 0;
+            }
+        }
+
+        cyc = UINT64_MAX;
+        for (int r = 0; r < TUNE_REPS; r++)
+        {
+            c0 = read_mcycle64();
+            invoke(cand[i].fn);
+            c0 = read_mcycle64() - c0;
+            if (c0 < cyc)
+            {
+                cyc = c0;
+            }
+        }
+
+        platform_puts(",cyc=");
+        platform_putdec(cyc);
+        platform_puts(ok ? ",status=ok\n" : ",status=mismatch\n");
+        if (ok && cyc < best_cyc)
+        {
+            best_cyc = cyc;
+            best = i;
+        }
+    }
+
+    tune_line("plan", layer, cand[best].name);
+    platform_putc('\n');
+    return best;
+}
+
+#endif // RESNET8_TUNE_H
@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+"""Batch benchmark of bare-metal variants built with -DBENCH (ResNet-8/bench.h).
+
+Every ELF runs under qemu-system-riscv64 with -icount, so mcycle/mtime follow the
+deterministic virtual clock; the runner exits through the virt test finisher and
+its exit status is checked. One row per (variant, icount shift) is printed and
+optionally written as CSV.
+
+  python3 Tools/bench.py resnet8.elf resnet8_strassen.elf resnet8_mlperf.elf
+  python3 Tools/bench.py --icount 0 --icount 3 --csv bench.csv *.elf
+"""
+import argparse
+import csv
+import os
+import subprocess
+import sys
+
+FIELDS = ("warmup", "iters", "cyc_min", "cyc_med", "cyc_p99", "instret_med", "mtime", "inf_s", "status")
+
+
+def run_variant(elf, shift, args):
+    cmd = [args.qemu, "-machine", "virt", "-cpu", args.cpu, "-nographic", "-bios", "none",
+           "-icount", "shift=%s" % shift, "-serial", "stdio", "-monitor", "none", "-kernel", elf] + args.qemu_arg
+    try:
+        proc = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.PIPE, timeout=args.timeout)
+    except subprocess.TimeoutExpired:
+        return None, "timeout after %gs (built without -DBENCH?)" % args.timeout
+    out = proc.stdout.decode(errors="replace")
+    for line in out.splitlines():
+        if line.startswith("bench,"):
+            parts = line.strip().split(",")
+            row = {"variant": parts[1]}
+            row.update(kv.split("=", 1) for kv in parts[2:])
+            row["exit"] = proc.returncode
+            return row, None
+    return None, "no bench line (exit %d): %s" % (proc.returncode, (out + proc.stderr.decode(errors="replace")).strip()[-200:])
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("elf", nargs="+", help="variants built with -DBENCH")
+    ap.add_argument("--qemu", default="qemu-system-riscv64")
+    ap.add_argument("--cpu", default="rv64")
+    ap.add_argument("--icount", action="append", default=[],
+                    help="icount shift (1 insn = 2^shift ns), repeatable; default 0")
+    ap.add_argument("--timeout", type=float, default=600.0, help="seconds per run")
+    ap.add_argument("--csv", help="also write the results to this CSV file")
+    ap.add_argument("--qemu-arg", action="append", default=[], help="extra QEMU argument (repeatable)")
+    args = ap.parse_args()
+    shifts = args.icount or ["0"]
+
+    rows, failed = [], 0
+    print("%-22s %-18s %6s %5s %13s %13s %13s %13s %11s %6s" % (
+        "variant", "elf", "shift", "iters", "cyc_min", "cyc_med", "cyc_p99", "instret_med", "inf/s", "exit"))
+    for elf in args.elf:
+        for shift in shifts:
+            row, err = run_variant(elf, shift, args)
+            if row is None:
+                print("%-22s %-18s %6s  %s" % ("-", os.path.basename(elf)[:18], shift, err))
+                failed += 1
+                continue
+            row["elf"], row["icount_shift"] = os.path.basename(elf), shift
+            rows.append(row)
+            failed += row["exit"] != 0
+            print("%-22s %-18s %6s %5s %13s %13s %13s %13s %11s %6d" % (
+                row["variant"][:22], row["elf"][:18], shift, row.get("iters"), row.get("cyc_min"), row.get("cyc_med"),
+                row.get("cyc_p99"), row.get("instret_med"), row.get("inf_s"), row["exit"]))
+
+    if args.csv:
+        with open(args.csv, "w", newline="") as f:
+            wr = csv.DictWriter(f, fieldnames=("variant", "elf", "icount_shift") + FIELDS + ("exit",), extrasaction="ignore")
+            wr.writeheader()
+            wr.writerows(rows)
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,182 @@
+#!/usr/bin/env python3
+"""Host side of the semihosting dataset runner (ResNet-8/dataset.h).
+
+Writes the three files a variant built with -DDATASET reads at run time:
+
+  images.bin   N frames of [3][32][32] uint8, planar (CIFAR-10 pixel order)
+  labels.bin   N bytes, class index per frame
+  weights.bin  the int8 weights / int32 biases of every conv2d, dwconv2d and fc layer of a
+               model description (same JSON and .bin files as Tools/resnet_aot.py),
+               concatenated in layer order, weights before bias
+
+Frames come from CIFAR-10 binary batches (test_batch.bin: 1 label byte + 3072
+pixel bytes per record), or are random with --synthetic for throughput-only runs.
+With --run the ELFs are started under qemu-system-riscv64 -semihosting in the
+output directory and their dataset lines are printed.
+
+  python3 Tools/dataset.py --cifar cifar-10-batches-bin/test_batch.bin \\
+      --model ResNet-8/models/resnet8.json --out-dir run --run resnet8_ds.elf
+  python3 Tools/dataset.py --synthetic 2000 --init random --out-dir run
+"""
+import argparse
+import json
+import os
+import random
+import struct
+import subprocess
+import sys
+
+FRAME = 3 * 32 * 32
+NUM_CLASSES = 10
+FIELDS = ("images", "correct", "acc", "cyc_avg", "mtime", "io_mtime", "inf_s", "status")
+
+
+def fail(msg):
+    sys.exit("dataset: " + msg)
+
+
+def read_cifar(paths, count):
+    images, labels = bytearray(), bytearray()
+    for path in paths:
+        with open(path, "rb") as f:
+            data = f.read()
+        if len(data) % (FRAME + 1):
+            fail("%s: not a CIFAR-10 binary batch (%d bytes)" % (path, len(data)))
+        for off in range(0, len(data), FRAME + 1):
+            if count and len(labels) == count:
+                return images, labels
+            labels.append(data[off])
+            images += data[off + 1:off + 1 + FRAME]
+    return images, labels
+
+
+def synthetic(count, rng):
+    images = bytes(rng.randrange(256) for _ in range(count * FRAME))
+    labels = bytes(rng.randrange(NUM_CLASSES) for _ in range(count))
+    return images, labels
+
+
+def tensor_blob(path, count, fmt, init, rng):
+    """`count` little-endian values of struct format `fmt`, from `path` or from --init."""
+    size = struct.calcsize(fmt)
+    if path is not None:
+        with open(path, "rb") as f:
+            data = f.read()
+        if len(data) != count * size:
+            fail("%s: expected %d bytes, got %d" % (path, count * size, len(data)))
+        return data
+    if init == "none":
+        fail("layer without weight files (pass --init ones|random for a plumbing run)")
+    if init == "ones":
+        values = [1 if fmt == "b" else 0] * count
+    else:
+        values = [rng.randrange(-3, 4) if fmt == "b" else rng.randrange(-1000, 1001) for _ in range(count)]
+    return struct.pack("<%d%s" % (count, fmt), *values)
+
+
+def weight_blob(model_path, init, rng):
+    with open(model_path) as f:
+        model = json.load(f)
+    base = os.path.dirname(os.path.abspath(model_path))
+    channels = {model["input"].get("name", "input"): model["input"]["shape"][0]}  # defaults as in resnet_aot.py
+    blob = bytearray()
+
+    def path(layer, key):
+        return os.path.join(base, layer[key]) if key in layer else None
+
+    for layer in model["layers"]:
+        op = layer["op"]
+        if op == "conv2d":
+            ic, oc, k = channels[layer["input"]], layer["out_c"], layer.get("k", 3)
+            blob += tensor_blob(path(layer, "weights"), oc * ic * k * k, "b", init, rng)
+            blob += tensor_blob(path(layer, "bias"), oc, "i", init, rng)
+            channels[layer["name"]] = oc
+        elif op == "dwconv2d":
+            c, k = channels[layer["input"]], layer.get("k", 3)
+            blob += tensor_blob(path(layer, "weights"), c * k * k, "b", init, rng)
+            blob += tensor_blob(path(layer, "bias"), c, "i", init, rng)
+            channels[layer["name"]] = c
+        elif op == "fc":
+            n_in, n_out = channels[layer["input"]], layer["out"]
+            blob += tensor_blob(path(layer, "weights"), n_out * n_in, "b", init, rng)
+            blob += tensor_blob(path(layer, "bias"), n_out, "i", init, rng)
+            channels[layer["name"]] = n_out
+        elif op == "add_relu":
+            channels[layer["name"]] = channels[layer["inputs"][0]]
+        elif op == "gap":
+            channels[layer["name"]] = channels[layer["input"]]
+        else:
+            fail("unknown op %r" % op)
+    return blob
+
+
+def run_elf(elf, args):
+    cmd = [args.qemu, "-machine", "virt", "-cpu", args.cpu, "-nographic", "-bios", "none",
+           "-semihosting-config", "enable=on,target=native", "-serial", "stdio", "-monitor", "none",
+           "-kernel", os.path.abspath(elf)]
+    if args.icount is not None:
+        cmd[-2:-2] = ["-icount", "shift=%s" % args.icount]
+    try:
+        proc = subprocess.run(cmd, cwd=args.out_dir, stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                              timeout=args.timeout)
+    except subprocess.TimeoutExpired:
+        return None, "timeout after %gs (built without -DDATASET?)" % args.timeout
+    out = proc.stdout.decode(errors="replace")
+    for line in out.splitlines():
+        if line.startswith("dataset,"):
+            parts = line.strip().split(",")
+            row = {"variant": parts[1]}
+            row.update(kv.split("=", 1) for kv in parts[2:] if "=" in kv)
+            row["exit"] = proc.returncode
+            return row, None
+    return None, "no dataset line (exit %d): %s" % (proc.returncode, (out + proc.stderr.decode(errors="replace")).strip()[-200:])
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    src = ap.add_mutually_exclusive_group(required=True)
+    src.add_argument("--cifar", action="append", help="CIFAR-10 binary batch (repeatable)")
+    src.add_argument("--synthetic", type=int, metavar="N", help="N random frames and labels")
+    ap.add_argument("--count", type=int, default=0, help="keep the first N CIFAR frames (0 = all)")
+    ap.add_argument("--model", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "ResNet-8",
+                                                    "models", "resnet8.json"))
+    ap.add_argument("--init", choices=("none", "ones", "random"), default="none",
+                    help="weights of layers without .bin files (default: refuse)")
+    ap.add_argument("--seed", type=int, default=1)
+    ap.add_argument("--out-dir", default=".")
+    ap.add_argument("--run", nargs="*", default=[], metavar="ELF", help="variants built with -DDATASET")
+    ap.add_argument("--qemu", default="qemu-system-riscv64")
+    ap.add_argument("--cpu", default="rv64")
+    ap.add_argument("--icount", help="icount shift (default: real time)")
+    ap.add_argument("--timeout", type=float, default=3600.0, help="seconds per run")
+    args = ap.parse_args()
+    rng = random.Random(args.seed)
+
+    if args.cifar:
+        images, labels = read_cifar(args.cifar, args.count)
+    else:
+        images, labels = synthetic(args.synthetic, rng)
+    if not labels:
+        fail("no frames")
+    blob = weight_blob(args.model, args.init, rng)
+
+    os.makedirs(args.out_dir, exist_ok=True)
+    for name, data in (("images.bin", images), ("labels.bin", labels), ("weights.bin", blob)):
+        with open(os.path.join(args.out_dir, name), "wb") as f:
+            f.write(data)
+    print("%d frames, %d weight bytes -> %s" % (len(labels), len(blob), args.out_dir))
+
+    failed = 0
+    for elf in args.run:
+        row, err = run_elf(elf, args)
+        if row is None:
+            print("%-22s %s" % (os.path.basename(elf), err))
+            failed += 1
+            continue
+        print("%-22s " % row["variant"] + " ".join("%s=%s" % (k, row.get(k, "-")) for k in FIELDS))
+        failed += row["exit"] != 0
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
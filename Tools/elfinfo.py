@@ -0,0 +1,63 @@
+"""Minimal little-endian ELF32/ELF64 reader for the host tools (no binutils needed).
+
+  sections, symbols = read_elf("resnet8.elf")
+
+sections: list of Section(name, type, flags, addr, size)
+symbols:  list of Symbol(name, value, size, type, section), section = section name
+          ("" for undefined or absolute symbols)
+"""
+import collections
+import struct
+import sys
+
+SHT_SYMTAB, SHT_NOBITS = 2, 8
+SHF_ALLOC = 0x2
+STT_NOTYPE, STT_OBJECT, STT_FUNC = 0, 1, 2
+SHN_LORESERVE = 0xFF00
+
+Section = collections.namedtuple("Section", "name type flags addr size")
+Symbol = collections.namedtuple("Symbol", "name value size type section")
+
+
+def _cstr(data, off):
+    return data[off:data.index(b"\0", off)].decode(errors="replace")
+
+
+def read_elf(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] != b"\x7fELF" or data[5] != 1:
+        sys.exit("%s: not a little-endian ELF file" % path)
+    is64 = data[4] == 2
+    if is64:
+        shoff, = struct.unpack_from("<Q", data, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x3A)
+        sh_fmt, sym_fmt = "<IIQQQQIIQQ", "<IBBHQQ"
+    else:
+        shoff, = struct.unpack_from("<I", data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x2E)
+        sh_fmt, sym_fmt = "<IIIIIIIIII", "<IIIBBH"
+
+    raw = []
+    for i in range(shnum):
+        sh_name, sh_type, sh_flags, sh_addr, sh_offset, sh_size, sh_link, _, _, sh_entsize = \
+            struct.unpack_from(sh_fmt, data, shoff + i * shentsize)
+        raw.append((sh_name, sh_type, sh_flags, sh_addr, sh_offset, sh_size, sh_link, sh_entsize))
+    names_off = raw[shstrndx][4] if shnum else 0
+    sections = [Section(_cstr(data, names_off + r[0]), r[1], r[2], r[3], r[5]) for r in raw]
+
+    symbols = []
+    for sh_name, sh_type, _, _, sh_offset, sh_size, sh_link, sh_entsize in raw:
+        if sh_type != SHT_SYMTAB:
+            continue
+        str_off = raw[sh_link][4]
+        for off in range(sh_offset, sh_offset + sh_size, sh_entsize):
+            if is64:
+                st_name, st_info, _, st_shndx, st_value, st_size = struct.unpack_from(sym_fmt, data, off)
+            else:
+                st_name, st_value, st_size, st_info, _, st_shndx = struct.unpack_from(sym_fmt, data, off)
+            if not st_name:
+                continue
+            sec = sections[st_shndx].name if 0 < st_shndx < SHN_LORESERVE else ""
+            symbols.append(Symbol(_cstr(data, str_off + st_name), st_value, st_size, st_info & 0xF, sec))
+    return sections, symbols
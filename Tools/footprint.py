@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+"""Static-RAM, flash and stack footprint of bare-metal variants.
+
+For every ELF the allocated sections are classed as text / rodata / data / bss /
+stack / hart_stacks and the largest symbols of each class are listed (static scratch buffers
+such as the Strassen temporaries or the residual t1/t2 show up by name). With
+--run each ELF built with -DFOOTPRINT (ResNet-8/footprint.h) is also executed
+under QEMU to get the measured stack high-water mark. A final budget table
+gives flash = text + rodata + data and RAM = data + bss + stack + hart_stacks per
+variant (stack = measured hart-0 high-water mark if available, else the reserved
+.stack; hart_stacks = the .stack.harts reservation of harts 1..3 in the rv64
+link.ld, always counted as reserved) and flags variants over --flash / --ram.
+
+  python3 Tools/footprint.py resnet8.elf resnet8_strassen.elf conv0_v2.elf
+  python3 Tools/footprint.py --run --ram 256 --flash 64 --csv mem.csv *.elf
+"""
+import argparse
+import csv
+import os
+import subprocess
+import sys
+
+from elfinfo import SHF_ALLOC, STT_FUNC, STT_NOTYPE, STT_OBJECT, read_elf
+
+CLASSES = ("text", "rodata", "data", "bss", "stack", "hart_stacks")
+# First match wins: .stack.harts before the .stack prefix that would also cover it
+PREFIXES = ((".text", "text"), (".rodata", "rodata"), (".srodata", "rodata"), (".data", "data"),
+            (".sdata", "data"), (".bss", "bss"), (".sbss", "bss"), (".stack.harts", "hart_stacks"),
+            (".stack", "stack"))
+
+
+def section_class(name):
+    for prefix, cls in PREFIXES:
+        if name == prefix or name.startswith(prefix + "."):
+            return cls
+    return None
+
+
+def analyse(elf):
+    sections, symbols = read_elf(elf)
+    sizes = dict.fromkeys(CLASSES, 0)
+    ends = {}
+    for sec in sections:
+        cls = section_class(sec.name)
+        if cls and sec.flags & SHF_ALLOC:
+            sizes[cls] += sec.size
+            ends[sec.name] = sec.addr + sec.size
+
+    # Sized symbols as they are; asm labels (no size) extend to the next symbol
+    # of the same section or to the section end
+    by_sec = {}
+    for s in symbols:
+        if s.section in ends and s.type in (STT_OBJECT, STT_FUNC, STT_NOTYPE) and not s.name.startswith((".L", "$")):
+            by_sec.setdefault(s.section, []).append(s)
+    per_class = dict((cls, []) for cls in CLASSES)
+    for sec, syms in by_sec.items():
+        syms.sort(key=lambda s: s.value)
+        for i, s in enumerate(syms):
+            size = s.size
+            if not size and s.type == STT_NOTYPE:
+                nxt = next((t.value for t in syms[i + 1:] if t.value > s.value), ends[sec])
+                size = nxt - s.value
+            if size:
+                per_class[section_class(sec)].append((size, s.name))
+    return sizes, per_class
+
+
+def run_elf(elf, args):
+    cmd = [args.qemu, "-machine", "virt", "-cpu", args.cpu, "-nographic", "-bios", "none",
+           "-serial", "stdio", "-monitor", "none", "-kernel", elf] + args.qemu_arg
+    try:
+        proc = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.PIPE, timeout=args.timeout)
+    except subprocess.TimeoutExpired:
+        return None
+    for line in proc.stdout.decode(errors="replace").splitlines():
+        if line.startswith("mem,"):
+            parts = line.strip().split(",")
+            return dict(kv.split("=", 1) for kv in parts[2:])
+    return None
+
+
+def kib(n):
+    return "%.1f" % (n / 1024.0)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("elf", nargs="+")
+    ap.add_argument("--run", action="store_true", help="run each ELF (built with -DFOOTPRINT) for the stack high-water mark")
+    ap.add_argument("--qemu", default="qemu-system-riscv64")
+    ap.add_argument("--cpu", default="rv64")
+    ap.add_argument("--timeout", type=float, default=600.0, help="seconds per run")
+    ap.add_argument("--top", type=int, default=8, help="symbols listed per section class (0 = none)")
+    ap.add_argument("--ram", type=float, help="RAM budget in KiB")
+    ap.add_argument("--flash", type=float, help="flash budget in KiB")
+    ap.add_argument("--csv", help="also write the budget table to this CSV file")
+    ap.add_argument("--qemu-arg", action="append", default=[], help="extra QEMU argument (repeatable)")
+    args = ap.parse_args()
+
+    rows = []
+    for elf in args.elf:
+        sizes, per_class = analyse(elf)
+        measured = run_elf(elf, args) if args.run else None
+        hwm = int(measured["stack_hwm"]) if measured else None
+        stack = hwm if hwm is not None else sizes["stack"]
+        row = dict(sizes, variant=os.path.basename(elf), stack_hwm="" if hwm is None else hwm,
+                   flash=sizes["text"] + sizes["rodata"] + sizes["data"],
+                   ram=sizes["data"] + sizes["bss"] + stack + sizes["hart_stacks"])
+        over = [k for k, budget in (("flash", args.flash), ("ram", args.ram)) if budget is not None and row[k] > budget * 1024]
+        row["status"] = "OVER:" + "+".join(over) if over else "ok"
+        rows.append(row)
+
+        if args.top:
+            print("== %s" % row["variant"])
+            for cls in CLASSES:
+                syms = sorted(per_class[cls], reverse=True)[:args.top]
+                if not syms:
+                    continue
+                print("   %-11s %8d B  %s" % (cls, sizes[cls], ", ".join("%s %d" % (n, sz) for sz, n in syms)))
+            if args.run and hwm is None:
+                print("   (no mem line: built without -DFOOTPRINT?)")
+            print()
+
+    print("%-24s %9s %9s %9s %9s %9s %9s %11s %10s %10s  %s" % (
+        "variant", "text", "rodata", "data", "bss", "stack", "stack_hwm", "hart_stacks", "flash KiB", "RAM KiB",
+        "status"))
+    for r in rows:
+        print("%-24s %9d %9d %9d %9d %9d %9s %11d %10s %10s  %s" % (
+            r["variant"][:24], r["text"], r["rodata"], r["data"], r["bss"], r["stack"], r["stack_hwm"],
+            r["hart_stacks"], kib(r["flash"]), kib(r["ram"]), r["status"]))
+
+    if args.csv:
+        with open(args.csv, "w", newline="") as f:
+            wr = csv.DictWriter(f, fieldnames=("variant",) + CLASSES + ("stack_hwm", "flash", "ram", "status"))
+            wr.writeheader()
+            wr.writerows(rows)
+    sys.exit(1 if any(r["status"] != "ok" for r in rows) else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,207 @@
+#!/usr/bin/env python3
+"""Load generator for the UART inference server (ResNet-8/serve.h).
+
+Starts a variant built with -DSERVE under qemu-system-riscv64 (-serial stdio),
+streams framed requests into its serial RX and matches the response lines by
+request id. Two modes:
+
+  closed loop (default)  --concurrency N requests outstanding, the next one sent
+                         as soon as one is answered: the sustained rate
+  open loop (--rate R)   Poisson arrivals at R requests/s; latency counts from the
+                         scheduled send time, so a server that falls behind shows
+                         up as latency rather than as a lower offered rate
+
+and prints one line per run
+
+  loadgen,<variant>,mode=..,requests=N,errors=E,req_s=X.XX,p50_ms=..,p95_ms=..,p99_ms=..,max_ms=..,cyc_avg=..,cyc_p99=..,wait_p99_us=..
+
+req_s and the *_ms latencies are host wall-clock, so they depend on the QEMU
+speed. cyc_* (mcycle per inference) and wait_p99_us (time queued on the target,
+mtime) come from the responses and follow the virtual clock, which is
+deterministic with --icount. The first --warmup requests (TCG translation) are
+left out of both. Frames are cycled from an images.bin written by
+Tools/dataset.py (--images), else random; with --labels the accuracy is printed
+too.
+
+  python3 Tools/loadgen.py --requests 200 --concurrency 4 resnet8_serve.elf
+  python3 Tools/loadgen.py --rate 20 --requests 500 --images run/images.bin --labels run/labels.bin resnet8_serve.elf
+"""
+import argparse
+import os
+import random
+import struct
+import subprocess
+import sys
+import threading
+import time
+
+FRAME = 3 * 32 * 32
+MTIME_HZ = 10000000  # virt timebase-frequency
+
+
+def fail(msg):
+    sys.exit("loadgen: " + msg)
+
+
+def request(rid, px):
+    """'R' 'Q' | id u32 | frame | sum u8 (serve.h)"""
+    body = struct.pack("<I", rid) + px
+    return b"RQ" + body + bytes([sum(body) & 0xFF])
+
+
+def fields(line):
+    return dict(kv.split("=", 1) for kv in line.strip().split(",") if "=" in kv)
+
+
+def percentile(values, p):
+    if not values:
+        return 0
+    values = sorted(values)
+    return values[min(len(values) - 1, int(p / 100.0 * len(values)))]
+
+
+class Server:
+    """The QEMU process; a reader thread collects the response lines by id."""
+
+    def __init__(self, elf, args):
+        cmd = [args.qemu, "-machine", "virt", "-cpu", args.cpu, "-nographic", "-bios", "none",
+               "-serial", "stdio", "-monitor", "none", "-kernel", elf] + args.qemu_arg
+        if args.icount is not None:
+            cmd[-2:-2] = ["-icount", "shift=%s" % args.icount]
+        self.proc = subprocess.Popen(cmd, stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+        self.cond = threading.Condition()
+        self.name, self.summary, self.eof = None, None, False
+        self.resp = {}
+        threading.Thread(target=self.read, daemon=True).start()
+
+    def read(self):
+        for raw in self.proc.stdout:
+            line = raw.decode(errors="replace").strip()
+            now = time.perf_counter()
+            with self.cond:
+                if line.startswith("serve,id="):
+                    f = fields(line)
+                    self.resp[int(f["id"])] = (now, f)
+                elif line.startswith("serve,") and ",ready" in line:
+                    self.name = line.split(",")[1]
+                elif line.startswith("serve,") and ",requests=" in line:
+                    self.summary = fields(line)
+                self.cond.notify_all()
+        with self.cond:
+            self.eof = True
+            self.cond.notify_all()
+
+    def wait(self, pred, timeout):
+        with self.cond:
+            return self.cond.wait_for(lambda: pred() or self.eof, timeout) and pred()
+
+    def send(self, data):
+        self.proc.stdin.write(data)
+        self.proc.stdin.flush()
+
+    def stop(self, timeout):
+        try:
+            self.send(b"QT")
+            self.proc.stdin.close()
+        except BrokenPipeError:
+            pass
+        self.wait(lambda: self.summary is not None, timeout)
+        try:
+            return self.proc.wait(timeout)
+        except subprocess.TimeoutExpired:
+            self.proc.kill()
+            return None
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("elf", help="variant built with -DSERVE")
+    ap.add_argument("--requests", type=int, default=100)
+    ap.add_argument("--warmup", type=int, default=5, help="requests left out of the statistics")
+    ap.add_argument("--concurrency", type=int, default=1, help="closed loop: requests outstanding")
+    ap.add_argument("--rate", type=float, help="open loop: Poisson arrivals, requests/s")
+    ap.add_argument("--images", help="images.bin of Tools/dataset.py (default: random frames)")
+    ap.add_argument("--labels", help="labels.bin matching --images, for the accuracy")
+    ap.add_argument("--seed", type=int, default=1)
+    ap.add_argument("--qemu", default="qemu-system-riscv64")
+    ap.add_argument("--cpu", default="rv64")
+    ap.add_argument("--icount", help="icount shift (virtual clock tied to instructions)")
+    ap.add_argument("--timeout", type=float, default=60.0, help="seconds to wait for a response")
+    ap.add_argument("--qemu-arg", action="append", default=[], help="extra QEMU argument (repeatable)")
+    args = ap.parse_args()
+    if args.requests <= args.warmup:
+        fail("--requests must exceed --warmup")
+
+    rng = random.Random(args.seed)
+    if args.images:
+        with open(args.images, "rb") as f:
+            data = f.read()
+        if not data or len(data) % FRAME:
+            fail("%s: not a file of %d-byte frames" % (args.images, FRAME))
+        frames = [data[i:i + FRAME] for i in range(0, len(data), FRAME)]
+    else:
+        frames = [bytes(rng.randrange(256) for _ in range(FRAME)) for _ in range(16)]
+    labels = None
+    if args.labels:
+        with open(args.labels, "rb") as f:
+            labels = f.read()
+        if len(labels) < len(frames):
+            fail("%s: fewer labels than frames" % args.labels)
+
+    srv = Server(os.path.abspath(args.elf), args)
+    if not srv.wait(lambda: srv.name is not None, args.timeout):
+        srv.proc.kill()
+        fail("no ready line from %s (built without -DSERVE?)" % args.elf)
+
+    sent = {}
+    n = args.requests
+    start = time.perf_counter()
+    due = start
+    try:
+        for i in range(n):
+            if args.rate:
+                due += rng.expovariate(args.rate)
+                delay = due - time.perf_counter()
+                if delay > 0:
+                    time.sleep(delay)
+                sent[i] = due
+            else:
+                # closed loop: at most `concurrency` requests unanswered
+                if not srv.wait(lambda: len(srv.resp) > i - args.concurrency, args.timeout):
+                    break
+                sent[i] = time.perf_counter()
+            srv.send(request(i, frames[i % len(frames)]))
+    except BrokenPipeError:
+        pass
+    srv.wait(lambda: len(srv.resp) >= len(sent), args.timeout)
+    status = srv.stop(args.timeout)
+
+    measured = [i for i in range(args.warmup, n) if i in srv.resp]
+    lat = [(srv.resp[i][0] - sent[i]) * 1000.0 for i in measured]
+    ok = [i for i in measured if srv.resp[i][1].get("status") == "0"]
+    cyc = [int(srv.resp[i][1]["cyc"]) for i in ok]
+    wait_us = [int(srv.resp[i][1]["wait"]) * 1000000 // MTIME_HZ for i in measured]
+    span = srv.resp[measured[-1]][0] - sent[args.warmup] if measured else 0
+    missing = n - len(srv.resp)
+    errors = len(measured) - len(ok) + missing
+
+    mode = "open,rate=%g" % args.rate if args.rate else "closed,concurrency=%d" % args.concurrency
+    line = "loadgen,%s,mode=%s,requests=%d,errors=%d,req_s=%.2f" % (srv.name, mode, len(measured), errors,
+                                                                      len(measured) / span if span > 0 else 0.0)
+    line += ",p50_ms=%.2f,p95_ms=%.2f,p99_ms=%.2f,max_ms=%.2f" % (
+        percentile(lat, 50), percentile(lat, 95), percentile(lat, 99), max(lat) if lat else 0.0)
+    line += ",cyc_avg=%d,cyc_p99=%d,wait_p99_us=%d" % (sum(cyc) // len(cyc) if cyc else 0, percentile(cyc, 99),
+                                                      percentile(wait_us, 99))
+    if labels is not None and ok:
+        correct = sum(int(srv.resp[i][1]["class"]) == labels[i % len(frames)] for i in ok)
+        line += ",acc=%.2f" % (100.0 * correct / len(ok))
+    print(line)
+    if srv.summary is not None:
+        print("target: " + ",".join("%s=%s" % kv for kv in srv.summary.items()))
+    if missing:
+        print("loadgen: %d requests unanswered" % missing, file=sys.stderr)
+    sys.exit(0 if status == 0 and not errors else 1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+"""Per-function profile of bare-metal variants under QEMU with the symprof TCG plugin.
+
+Runs every ELF under qemu-system-riscv64 with Tools/qemu-plugins/symprof.c loaded,
+collects dynamic instructions, loads/stores and simulated L1 I/D misses per symbol
+and prints one report per variant followed by a cross-variant comparison.
+
+  python3 Tools/profile.py --plugin ./libsymprof.so resnet8.elf resnet8_strassen.elf
+  python3 Tools/profile.py --plugin ./libsymprof.so --dcache 16384:4:32 \\
+      --symbols conv2d_qrelu_32in,strassen_mul,buildB_conv0,conv0_v2 *.elf
+"""
+import argparse
+import os
+import select
+import signal
+import subprocess
+import sys
+import tempfile
+import time
+
+FIELDS = ("insns", "loads", "stores", "load_bytes", "store_bytes", "i_miss", "d_load_miss", "d_store_miss")
+
+
+def run_variant(elf, args):
+    log = tempfile.NamedTemporaryFile(prefix="symprof-", suffix=".log", delete=False)
+    log.close()
+    plugin = "%s,icache=%s,dcache=%s" % (os.path.abspath(args.plugin), args.icache, args.dcache)
+    cmd = [args.qemu, "-machine", "virt", "-cpu", args.cpu, "-nographic", "-bios", "none",
+           "-accel", "tcg,thread=single", "-serial", "stdio", "-monitor", "none",
+           "-plugin", plugin, "-d", "plugin", "-D", log.name, "-kernel", elf] + args.qemu_arg
+    proc = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=sys.stderr)
+
+    # Variants print one line and park in an idle loop (the plugin stops counting
+    # there); a variant that exits on its own is fine too.
+    out = b""
+    deadline = time.time() + args.timeout
+    while proc.poll() is None and time.time() < deadline:
+        ready, _, _ = select.select([proc.stdout], [], [], 0.1)
+        if ready:
+            chunk = os.read(proc.stdout.fileno(), 4096)
+            if not chunk:
+                break
+            out += chunk
+            if out.count(b"\n") >= args.lines:
+                break
+    if proc.poll() is None:
+        time.sleep(0.2)
+        proc.send_signal(signal.SIGTERM)  # QEMU runs plugin atexit callbacks on SIGTERM
+    proc.wait()
+
+    stats, config = {}, ""
+    with open(log.name) as f:
+        for line in f:
+            parts = line.strip().split(",")
+            if parts[0] == "symprof" and len(parts) == 2 + len(FIELDS):
+                stats[parts[1]] = dict(zip(FIELDS, map(int, parts[2:])))
+            elif parts[0] == "symprof-config":
+                config = ",".join(parts[1:])
+    os.unlink(log.name)
+    return out.decode(errors="replace").strip(), config, stats
+
+
+def pct(a, b):
+    return "%5.1f%%" % (100.0 * a / b) if b else "    -"
+
+
+def print_variant(name, uart, config, stats, top, line):
+    total = {k: sum(s[k] for s in stats.values()) for k in FIELDS}
+    print("== %s  [%s]" % (name, config))
+    if uart:
+        print("   uart: %s" % uart.replace("\n", " | "))
+    # D-bytes: line fills from the next level (D-misses x line size)
+    print("%-28s %12s %7s %11s %11s %9s %9s %9s %11s" % ("symbol", "insns", "share", "loads", "stores", "I-miss", "D-miss",
+                                                         "D-miss%", "D-bytes"))
+    rows = sorted(stats.items(), key=lambda kv: kv[1]["insns"], reverse=True)[:top]
+    for sym, s in rows:
+        d_miss = s["d_load_miss"] + s["d_store_miss"]
+        print("%-28s %12d %7s %11d %11d %9d %9d %9s %11d" % (sym[:28], s["insns"], pct(s["insns"], total["insns"]), s["loads"],
+                                                          s["stores"], s["i_miss"], d_miss, pct(d_miss, s["loads"] + s["stores"]),
+                                                          d_miss * line))
+    d_miss = total["d_load_miss"] + total["d_store_miss"]
+    print("%-28s %12d %7s %11d %11d %9d %9d %9s %11d\n" % ("TOTAL", total["insns"], "", total["loads"], total["stores"],
+                                                           total["i_miss"], d_miss, pct(d_miss, total["loads"] + total["stores"]),
+                                                           d_miss * line))
+
+
+def print_comparison(results, symbols):
+    names = [os.path.basename(elf) for elf, _, _, _ in results]
+    print("== comparison (insns / loads+stores / D-misses)")
+    print("%-24s" % "symbol" + "".join(" %30s" % n[:30] for n in names))
+    for sym in symbols:
+        cells = []
+        for _, _, _, stats in results:
+            s = stats.get(sym)
+            cells.append(" %30s" % ("%d / %d / %d" % (s["insns"], s["loads"] + s["stores"], s["d_load_miss"] + s["d_store_miss"])
+                                     if s else "-"))
+        print("%-24s" % sym[:24] + "".join(cells))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("elf", nargs="+", help="bare-metal ELF (static functions show up only if not inlined)")
+    ap.add_argument("--plugin", required=True, help="path to libsymprof.so")
+    ap.add_argument("--qemu", default="qemu-system-riscv64")
+    ap.add_argument("--cpu", default="rv64")
+    ap.add_argument("--icache", default="32768:8:64", help="L1 I-cache size:assoc:line (bytes)")
+    ap.add_argument("--dcache", default="32768:8:64", help="L1 D-cache size:assoc:line (bytes)")
+    ap.add_argument("--symbols", default="conv0,conv0_strassen,conv2d_qrelu_32in,conv2d_qlinear_32in,strassen_mul,"
+                                         "buildB_conv0,conv0_v1,conv0_v2,conv0_v3,conv0_v4,conv0_rgbx",
+                    help="comma-separated symbols for the cross-variant table")
+    ap.add_argument("--top", type=int, default=15, help="rows per variant report")
+    ap.add_argument("--lines", type=int, default=1, help="UART lines to wait for before stopping QEMU")
+    ap.add_argument("--timeout", type=float, default=600.0, help="seconds per variant")
+    ap.add_argument("--qemu-arg", action="append", default=[], help="extra QEMU argument (repeatable)")
+    args = ap.parse_args()
+
+    results = []
+    for elf in args.elf:
+        uart, config, stats = run_variant(elf, args)
+        if not stats:
+            sys.exit("%s: no symprof output (is the plugin built for this QEMU?)" % elf)
+        print_variant(os.path.basename(elf), uart, config, stats, args.top, int(args.dcache.split(":")[2]))
+        results.append((elf, uart, config, stats))
+    if len(results) > 1:
+        print_comparison(results, [s for s in args.symbols.split(",") if s])
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,432 @@
+#!/usr/bin/env python3
+"""Ahead-of-time compiler: model description (JSON) -> self-contained bare-metal C file.
+
+The generated file contains
+  - the kernel library (ResNet-8/kernels.h, pasted in) with one kernel instantiated
+    per distinct layer shape/epilogue, so every loop bound is a constant,
+  - the weights and biases as const arrays (read from the model's weight files),
+  - one static activation arena whose layout is planned from tensor lifetimes,
+  - a straight-line <name>_infer() that calls the kernels in schedule order,
+  - optionally (--main) a test main() printing the mcycle count like the other variants
+    (ResNet-8/platform.h pasted in, so rv32 builds read the full 64-bit counter), or,
+    built with -DBENCH, running the ResNet-8/bench.h benchmark runner.
+
+  python3 Tools/resnet_aot.py ResNet-8/models/resnet8.json -o resnet8_aot.c --main
+
+Model description
+  {
+    "name": "resnet8", "qshift": 8,
+    "input": {"name": "input", "shape": [3, 32, 32]},
+    "layers": [
+      {"name": "conv0", "op": "conv2d", "input": "input", "out_c": 32, "k": 3, "stride": 1, "pad": 1,
+       "act": "relu", "weights": "conv0_w.bin", "bias": "conv0_b.bin"},
+      {"name": "rb1", "op": "add_relu", "inputs": ["conv0", "rb1_conv2"]},
+      {"name": "gap", "op": "gap", "input": "rb3"},
+      {"name": "fc", "op": "fc", "input": "gap", "out": 10, "act": "linear"}
+    ],
+    "output": "fc"
+  }
+ops: conv2d (OIHW int8 weights, int32 bias), dwconv2d (depthwise, int8 [C][k][k],
+int32 bias, out_c = in_c), add_relu (skip add saturated to [0,127]), gap (global
+average pooling, H*W must be a power of two), fc (int8 [out][in], int32 bias).
+A 1x1/stride 1 conv2d runs on the register-tiled pointwise kernel when out_c and
+H*W are multiples of 4, so dwconv2d + 1x1 conv2d pairs describe depthwise-separable
+convolutions (models/resnet8_dws.json).
+act: relu | linear; "qshift" may be overridden per layer. A conv2d may give "pad_lo"
+and "pad_hi" instead of "pad" for asymmetric padding (Keras padding='same' with
+stride 2 on an even input: 0 and 1). Weight files are raw
+little-endian binaries relative to the JSON file; layers without them get the
+--init pattern (ones: weights 1 / bias 0, as in the hand-written test mains).
+"""
+import argparse
+import json
+import os
+import struct
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+KERNELS_H = os.path.join(HERE, "..", "ResNet-8", "kernels.h")
+BENCH_H = os.path.join(HERE, "..", "ResNet-8", "bench.h")
+PLATFORM_H = os.path.join(HERE, "..", "ResNet-8", "platform.h")
+ARENA_ALIGN = 16
+
+
+class Tensor:
+    def __init__(self, name, shape, producer):
+        self.name, self.shape, self.producer = name, tuple(shape), producer
+        self.last_use = producer
+        self.offset = None
+        self.alias = None  # tensor whose storage is reused in place
+        self.inplace_of = ()  # candidates for alias (elementwise producers)
+
+    @property
+    def size(self):
+        n = 1
+        for d in self.shape:
+            n *= d
+        return n
+
+    def c_type(self):
+        return "int8_t (*)" + "".join("[%d]" % d for d in self.shape[1:])
+
+
+def fail(msg):
+    sys.exit("resnet_aot: " + msg)
+
+
+def conv_out(n, k, s, p_lo, p_hi=None):
+    return (n + p_lo + (p_lo if p_hi is None else p_hi) - k) // s + 1
+
+
+def paste(w, path):
+    """Inlines a ResNet-8 header; the generated file is self-contained, so local includes are dropped."""
+    base = os.path.basename(path)
+    w("// ---- %s ----" % base)
+    with open(path) as f:
+        w("".join(l for l in f if not l.startswith('#include "')).rstrip())
+    w("// ---- end of %s ----" % base)
+
+
+def load_blob(path, count, fmt, init):
+    if path is None:
+        return [init] * count
+    with open(path, "rb") as f:
+        data = f.read()
+    size = struct.calcsize(fmt)
+    if len(data) != count * size:
+        fail("%s: expected %d bytes, got %d" % (path, count * size, len(data)))
+    return list(struct.unpack("<%d%s" % (count, fmt), data))
+
+
+def c_array(values, shape, indent=1):
+    """Brace-nested initializer for an array of the given shape; a constant array
+    becomes nested range designators ({[0 ... 31] = {[0 ... 2] = ...}})."""
+    if all(v == values[0] for v in values):
+        init = str(values[0])
+        for n in reversed(shape):
+            init = "{[0 ... %d] = %s}" % (n - 1, init)
+        return init
+    if len(shape) <= 2:
+        row = shape[-1] if len(shape) == 2 else len(values)
+        rows = ["{" + ", ".join(str(v) for v in values[i:i + row]) + "}" for i in range(0, len(values), row)]
+        if len(shape) == 1:
+            return rows[0]
+        return "{" + ", ".join(rows) + "}" if len(values) <= 64 else \
+            "{\n" + ",\n".join("    " * indent + r for r in rows) + "}"
+    step = len(values) // shape[0]
+    subs = [c_array(values[i:i + step], shape[1:], indent + 1) for i in range(0, len(values), step)]
+    return "{\n" + ",\n".join("    " * indent + sub for sub in subs) + "}"
+
+
+class Compiler:
+    def __init__(self, model, base_dir, init):
+        self.m = model
+        self.base_dir = base_dir
+        self.init_w, self.init_b = (1, 0) if init == "ones" else (0, 0)
+        self.qshift = model.get("qshift", 8)
+        self.tensors = {}
+        self.kernels = {}  # signature -> kernel name
+        self.kernel_defs = []
+        self.epilogue_shifts = set()
+        self.weights = []
+        self.calls = []
+
+    def tensor(self, name, step):
+        if name not in self.tensors:
+            fail("layer %d uses unknown tensor '%s'" % (step, name))
+        t = self.tensors[name]
+        t.last_use = max(t.last_use, step)
+        return t
+
+    def epilogue(self, layer):
+        act = layer.get("act", "linear")
+        if act not in ("relu", "linear"):
+            fail("%s: unknown act '%s'" % (layer["name"], act))
+        base = "relu" if act == "relu" else "quant_clip"
+        shift = layer.get("qshift", self.qshift)
+        if shift == self.qshift:
+            return base
+        self.epilogue_shifts.add(shift)
+        return "%s_s%d" % (base, shift)
+
+    def kernel(self, signature, name, definition):
+        if signature not in self.kernels:
+            self.kernels[signature] = name
+            self.kernel_defs.append(definition)
+        return self.kernels[signature]
+
+    def blob(self, layer, key):
+        path = layer.get(key)
+        return os.path.join(self.base_dir, path) if path else None
+
+    def compile(self):
+        inp = self.m["input"]
+        self.tensors[inp.get("name", "input")] = Tensor(inp.get("name", "input"), inp["shape"], -1)
+        for step, layer in enumerate(self.m["layers"]):
+            op, name = layer["op"], layer["name"]
+            if name in self.tensors:
+                fail("duplicate tensor name '%s'" % name)
+            if op == "conv2d":
+                x = self.tensor(layer["input"], step)
+                if len(x.shape) != 3:
+                    fail("%s: conv2d needs a CHW input" % name)
+                ic, ih, iw = x.shape
+                oc, k = layer["out_c"], layer.get("k", 3)
+                s, p = layer.get("stride", 1), layer.get("pad", k // 2)
+                p_lo, p_hi = layer.get("pad_lo", p), layer.get("pad_hi", p)
+                oh, ow = conv_out(ih, k, s, p_lo, p_hi), conv_out(iw, k, s, p_lo, p_hi)
+                epi = self.epilogue(layer)
+                w = load_blob(self.blob(layer, "weights"), oc * ic * k * k, "b", self.init_w)
+                b = load_blob(self.blob(layer, "bias"), oc, "i", self.init_b)
+                if (k, s, p_lo, p_hi) == (1, 1, 0, 0) and oc % 4 == 0 and ih * iw % 4 == 0:
+                    kname = "pwconv_%dx%dx%d_%d_%s" % (ic, ih, iw, oc, epi)
+                    kname = self.kernel(kname, kname, "DEFINE_CONV2D_PW(%s, %d, %d, %d, %d, %s)" %
+                                        (kname, ic, ih, iw, oc, epi))
+                    self.weights.append("static const int8_t %s_w[%d][%d] = %s;" % (name, oc, ic, c_array(w, (oc, ic))))
+                elif p_lo != p_hi:
+                    kname = "conv_%dx%dx%d_%d_k%ds%dp%d%d_%s" % (ic, ih, iw, oc, k, s, p_lo, p_hi, epi)
+                    kname = self.kernel(kname, kname, "DEFINE_CONV2D_PAD(%s, %d, %d, %d, %d, %d, %d, %d, %d, %s)" %
+                                        (kname, ic, ih, iw, oc, k, s, p_lo, p_hi, epi))
+                    self.weights.append("static const int8_t %s_w[%d][%d][%d][%d] = %s;" % (name, oc, ic, k, k, c_array(w, (oc, ic, k, k))))
+                else:
+                    kname = "conv_%dx%dx%d_%d_k%ds%dp%d_%s" % (ic, ih, iw, oc, k, s, p_lo, epi)
+                    kname = self.kernel(kname, kname, "DEFINE_CONV2D(%s, %d, %d, %d, %d, %d, %d, %d, %s)" %
+                                        (kname, ic, ih, iw, oc, k, s, p_lo, epi))
+                    self.weights.append("static const int8_t %s_w[%d][%d][%d][%d] = %s;" % (name, oc, ic, k, k, c_array(w, (oc, ic, k, k))))
+                self.weights.append("static const int32_t %s_b[%d] = %s;" % (name, oc, c_array(b, (oc,))))
+                y = Tensor(name, (oc, oh, ow), step)
+                self.calls.append((kname, [x, y], ["%s_w" % name, "%s_b" % name], layer))
+            elif op == "dwconv2d":
+                x = self.tensor(layer["input"], step)
+                if len(x.shape) != 3:
+                    fail("%s: dwconv2d needs a CHW input" % name)
+                c, ih, iw = x.shape
+                if layer.get("out_c", c) != c:
+                    fail("%s: dwconv2d keeps the %d channels" % (name, c))
+                k = layer.get("k", 3)
+                s, p = layer.get("stride", 1), layer.get("pad", k // 2)
+                oh, ow = conv_out(ih, k, s, p), conv_out(iw, k, s, p)
+                epi = self.epilogue(layer)
+                kname = "dwconv_%dx%dx%d_k%ds%dp%d_%s" % (c, ih, iw, k, s, p, epi)
+                kname = self.kernel(kname, kname, "DEFINE_DWCONV2D(%s, %d, %d, %d, %d, %d, %d, %s)" %
+                                    (kname, c, ih, iw, k, s, p, epi))
+                w = load_blob(self.blob(layer, "weights"), c * k * k, "b", self.init_w)
+                b = load_blob(self.blob(layer, "bias"), c, "i", self.init_b)
+                self.weights.append("static const int8_t %s_w[%d][%d][%d] = %s;" % (name, c, k, k, c_array(w, (c, k, k))))
+                self.weights.append("static const int32_t %s_b[%d] = %s;" % (name, c, c_array(b, (c,))))
+                y = Tensor(name, (c, oh, ow), step)
+                self.calls.append((kname, [x, y], ["%s_w" % name, "%s_b" % name], layer))
+            elif op == "add_relu":
+                a, b = (self.tensor(t, step) for t in layer["inputs"])
+                if a.shape != b.shape:
+                    fail("%s: add of %s and %s" % (name, a.shape, b.shape))
+                kname = "add_relu_%dx%dx%d" % a.shape
+                kname = self.kernel(kname, kname, "DEFINE_SKIP_ADD_RELU(%s, %d, %d, %d)" % ((kname,) + a.shape))
+                y = Tensor(name, a.shape, step)
+                y.inplace_of = (a, b)  # elementwise: may overwrite an input that dies here
+                self.calls.append((kname, [a, b, y], [], layer))
+            elif op == "gap":
+                x = self.tensor(layer["input"], step)
+                c, h, w = x.shape
+                shift = (h * w).bit_length() - 1
+                if h * w != 1 << shift:
+                    fail("%s: gap needs H*W to be a power of two" % name)
+                kname = "gap_%dx%dx%d" % x.shape
+                kname = self.kernel(kname, kname, "DEFINE_GLOBAL_AVG_POOL(%s, %d, %d, %d, %d)" % (kname, c, h, w, shift))
+                y = Tensor(name, (c,), step)
+                self.calls.append((kname, [x, y], [], layer))
+            elif op == "fc":
+                x = self.tensor(layer["input"], step)
+                if len(x.shape) != 1:
+                    fail("%s: fc needs a vector input" % name)
+                n_in, n_out = x.shape[0], layer["out"]
+                epi = self.epilogue(layer)
+                kname = "fc_%d_%d_%s" % (n_in, n_out, epi)
+                kname = self.kernel(kname, kname, "DEFINE_FC(%s, %d, %d, %s)" % (kname, n_in, n_out, epi))
+                w = load_blob(self.blob(layer, "weights"), n_out * n_in, "b", self.init_w)
+                b = load_blob(self.blob(layer, "bias"), n_out, "i", self.init_b)
+                self.weights.append("static const int8_t %s_w[%d][%d] = %s;" % (name, n_out, n_in, c_array(w, (n_out, n_in))))
+                self.weights.append("static const int32_t %s_b[%d] = %s;" % (name, n_out, c_array(b, (n_out,))))
+                y = Tensor(name, (n_out,), step)
+                self.calls.append((kname, [x, y], ["%s_w" % name, "%s_b" % name], layer))
+            else:
+                fail("%s: unknown op '%s'" % (name, op))
+            self.tensors[name] = y
+        if self.m["output"] not in self.tensors:
+            fail("unknown output '%s'" % self.m["output"])
+        self.tensors[self.m["output"]].last_use = len(self.m["layers"])
+        self.plan()
+
+    def plan(self):
+        """Greedy first-fit (largest first) offsets for tensors with overlapping lifetimes."""
+        inp, out = self.m["input"].get("name", "input"), self.m["output"]
+        for t in sorted(self.tensors.values(), key=lambda t: t.producer):
+            for src in t.inplace_of:
+                if src.last_use == t.producer and src.name not in (inp, out) and t.name != out:
+                    t.alias = src
+                    break
+        live = [t for t in self.tensors.values() if t.name not in (inp, out) and t.alias is None]
+        # a tensor written in place extends the lifetime of the storage it reuses
+        for t in self.tensors.values():
+            if t.alias is not None:
+                root = t.alias
+                while root.alias is not None:
+                    root = root.alias
+                root.last_use = max(root.last_use, t.last_use)
+        placed = []
+        self.arena = 0
+        for t in sorted(live, key=lambda t: (-t.size, t.producer)):
+            offset = 0
+            for o in sorted(placed, key=lambda o: o.offset):
+                overlap = not (t.last_use < o.producer or o.last_use < t.producer)
+                if overlap and offset + t.size > o.offset and o.offset + o.size > offset:
+                    offset = (o.offset + o.size + ARENA_ALIGN - 1) // ARENA_ALIGN * ARENA_ALIGN
+            t.offset = offset
+            placed.append(t)
+            self.arena = max(self.arena, offset + t.size)
+        for t in self.tensors.values():
+            if t.alias is not None:
+                root = t.alias
+                while root.alias is not None:
+                    root = root.alias
+                t.offset = root.offset
+
+    def ref(self, t):
+        inp, out = self.m["input"].get("name", "input"), self.m["output"]
+        if t.name == inp:
+            return "input"
+        if t.name == out:
+            return "output"
+        return "%s_out" % t.name
+
+    def emit(self, src_name, with_main):
+        m = self.m
+        name = m.get("name", "model")
+        inp = self.tensors[m["input"].get("name", "input")]
+        out = self.tensors[m["output"]]
+        lines = []
+        w = lines.append
+        w("// Generated by Tools/resnet_aot.py from %s -- do not edit." % src_name)
+        w("// %d layers, %d kernels, activation arena %d bytes" % (len(m["layers"]), len(self.kernel_defs), self.arena))
+        w("#include <stdint.h>")
+        w("#define QSHIFT %d" % self.qshift)
+        w("#define UART_TX 0x10000000UL")
+        w("")
+        w("// ---- kernels.h ----")
+        with open(KERNELS_H) as f:
+            w(f.read().rstrip())
+        w("// ---- end of kernels.h ----")
+        w("")
+        for shift in sorted(self.epilogue_shifts):
+            w("DEFINE_EPILOGUES(s%d, %d)" % (shift, shift))
+        w("// Kernels, one per distinct layer shape")
+        lines.extend(self.kernel_defs)
+        w("")
+        w("// Weights & Biases")
+        lines.extend(self.weights)
+        w("")
+        w("// Activation arena: tensors with disjoint lifetimes share storage")
+        w("static int8_t arena[%d] __attribute__((aligned(%d)));" % (max(self.arena, 1), ARENA_ALIGN))
+        for t in sorted(self.tensors.values(), key=lambda t: t.producer):
+            if t in (inp, out):
+                continue
+            w("#define %s_out ((%s)(arena + %d)) // %s, live [%d, %d]%s" % (
+                t.name, t.c_type(), t.offset, "x".join(map(str, t.shape)), t.producer, t.last_use,
+                ", in place of %s" % t.alias.name if t.alias is not None else ""))
+        w("")
+        dims = lambda t: "".join("[%d]" % d for d in t.shape)
+        w("void %s_infer(const int8_t input%s, int8_t output%s)" % (name, dims(inp), dims(out)))
+        w("{")
+        for kname, tensors, params, layer in self.calls:
+            args = [self.ref(t) for t in tensors] + params
+            w("    %s(%s); // %s" % (kname, ", ".join(args), layer["name"]))
+        w("}")
+        if with_main:
+            w("")
+            paste(w, PLATFORM_H)
+            w("#ifdef BENCH")
+            paste(w, BENCH_H)
+            w("#endif")
+            w(MAIN_TEMPLATE % dict(name=name, in_dims=dims(inp), out_dims=dims(out), out_len=out.size,
+                                   c=inp.shape[0], h=inp.shape[1], w=inp.shape[2]))
+        return "\n".join(lines) + "\n"
+
+
+MAIN_TEMPLATE = r"""
+// UART print
+static inline void uart_putc(char c) { *(volatile uint8_t *)UART_TX = (uint8_t)c; }
+static void uart_puts(const char *s)
+{
+    while (*s)
+    {
+        uart_putc(*s++);
+    }
+}
+static void uart_puthex64(uint64_t x)
+{
+    static const char H[] = "0123456789ABCDEF";
+    for (int i = 15; i >= 0; i--)
+    {
+        uart_putc(H[(x >> (i * 4)) & 0xF]);
+    }
+}
+
+static int8_t input%(in_dims)s;
+static int8_t logits%(out_dims)s;
+
+#ifdef BENCH
+static void bench_infer(void) { %(name)s_infer(input, logits); }
+#endif
+
+int main()
+{
+    for (int c = 0; c < %(c)d; c++) // test values
+    {
+        for (int h = 0; h < %(h)d; h++)
+        {
+            for (int w = 0; w < %(w)d; w++)
+            {
+                input[c][h][w] = (int8_t)(c + 1);
+            }
+        }
+    }
+
+#ifdef BENCH
+    bench_run("%(name)s_aot", bench_infer, (const int8_t *)logits, %(out_len)d);
+#endif
+
+    uint64_t t0 = read_mcycle64();
+    %(name)s_infer(input, logits);
+    uint64_t t1 = read_mcycle64();
+
+    uart_puts("%(name)s cycles: 0x");
+    uart_puthex64(t1 - t0);
+    uart_putc('\n');
+
+    for (;;)
+    {
+    }
+    return 0;
+}"""
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("model", help="model description (JSON)")
+    ap.add_argument("-o", "--output", required=True, help="generated C file")
+    ap.add_argument("--init", choices=("ones", "zeros"), default="ones",
+                    help="values for layers without weight files (ones: w=1, b=0)")
+    ap.add_argument("--main", action="store_true", help="also emit a test main() with mcycle print")
+    args = ap.parse_args()
+
+    with open(args.model) as f:
+        model = json.load(f)
+    c = Compiler(model, os.path.dirname(os.path.abspath(args.model)), args.init)
+    c.compile()
+    with open(args.output, "w") as f:
+        f.write(c.emit(os.path.basename(args.model), args.main))
+    print("%s: %d layers, %d kernels, arena %d bytes" % (args.output, len(model["layers"]), len(c.kernel_defs), c.arena))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""Symbolised report of the timer-interrupt sampling profiler (ResNet-8/sprof.h).
+
+Runs an ELF built with -DSPROF under qemu-system-riscv64 (or reads the UART log
+captured from a board with --log), parses the sprof histogram and resolves the
+sampled addresses against the ELF symbol table: one row per function with its
+share of the samples, then the hottest buckets as symbol+offset.
+
+  python3 Tools/sprof.py resnet8.elf
+  python3 Tools/sprof.py --icount 0 --hot 20 resnet8_strassen.elf
+  python3 Tools/sprof.py --log uart.txt resnet8.elf      # profile taken on hardware
+"""
+import argparse
+import bisect
+import subprocess
+import sys
+
+from elfinfo import STT_FUNC, STT_NOTYPE, read_elf
+
+
+def elf_symbols(path):
+    """(address, size, name) of the function and label symbols, sorted by address."""
+    _, symbols = read_elf(path)
+    syms = sorted((s.value, s.size, s.name) for s in symbols
+                  if s.section and s.type in (STT_FUNC, STT_NOTYPE)
+                  and not s.name.startswith((".L", "$", "_text_")))
+    if not syms:
+        sys.exit("%s: no symbol table (stripped?)" % path)
+    return syms
+
+
+def resolve(syms, addrs_of, addr):
+    """Symbol containing addr: sized symbols by extent, labels up to the next symbol."""
+    i = bisect.bisect_right(addrs_of, addr) - 1
+    while i >= 0:
+        value, size, name = syms[i]
+        if size == 0 or addr < value + size:
+            return name, addr - value
+        i -= 1
+    return "?", addr
+
+
+def run_elf(elf, args):
+    cmd = [args.qemu, "-machine", "virt", "-cpu", args.cpu, "-nographic", "-bios", "none",
+           "-serial", "stdio", "-monitor", "none", "-kernel", elf] + args.qemu_arg
+    if args.icount is not None:
+        cmd[1:1] = ["-icount", "shift=%s" % args.icount]
+    try:
+        proc = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.PIPE, timeout=args.timeout)
+    except subprocess.TimeoutExpired:
+        sys.exit("%s: timeout after %gs (built without -DSPROF?)" % (elf, args.timeout))
+    if proc.returncode != 0:
+        sys.exit("%s: exit status %d (%s)" % (elf, proc.returncode,
+                                              "trap in the profiled code" if proc.returncode == 2 else "see output"))
+    return proc.stdout.decode(errors="replace")
+
+
+def parse(text):
+    header, hist = None, []
+    for line in text.splitlines():
+        parts = line.strip().split(",")
+        if parts[0] != "sprof":
+            continue
+        if parts[1] == "begin":
+            header = {"name": parts[2]}
+            header.update(kv.split("=", 1) for kv in parts[3:])
+            hist = []
+        elif parts[1] == "end":
+            return header, hist
+        elif header is not None:
+            hist.append((int(parts[1], 16), int(parts[2])))
+    sys.exit("no complete sprof dump in the UART output")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("elf", help="variant built with -DSPROF (the same ELF that produced --log)")
+    ap.add_argument("--log", help="UART capture to read instead of running QEMU")
+    ap.add_argument("--qemu", default="qemu-system-riscv64")
+    ap.add_argument("--cpu", default="rv64")
+    ap.add_argument("--icount", help="run with -icount shift=N (mtime follows the instruction count)")
+    ap.add_argument("--timeout", type=float, default=600.0, help="seconds")
+    ap.add_argument("--top", type=int, default=20, help="functions to list")
+    ap.add_argument("--hot", type=int, default=10, help="hottest buckets to list (0 = none)")
+    ap.add_argument("--qemu-arg", action="append", default=[], help="extra QEMU argument (repeatable)")
+    args = ap.parse_args()
+
+    if args.log:
+        with open(args.log, errors="replace") as f:
+            text = f.read()
+    else:
+        text = run_elf(args.elf, args)
+    header, hist = parse(text)
+    syms = elf_symbols(args.elf)
+    addrs_of = [s[0] for s in syms]
+
+    total = sum(n for _, n in hist)
+    dropped = int(header.get("dropped", 0))
+    per_sym = {}
+    for addr, n in hist:
+        name, _ = resolve(syms, addrs_of, addr)
+        per_sym[name] = per_sym.get(name, 0) + n
+
+    def share(n):
+        return 100.0 * n / total if total else 0.0
+
+    print("== %s  iters=%s period=%s ticks, bucket=%d B, %d samples (%d outside .text window)" % (
+        header["name"], header.get("iters"), header.get("period"), 1 << int(header.get("shift", 0)),
+        total + dropped, dropped))
+    print("%-32s %9s %7s" % ("symbol", "samples", "share"))
+    for name, n in sorted(per_sym.items(), key=lambda kv: kv[1], reverse=True)[:args.top]:
+        print("%-32s %9d %6.1f%%" % (name[:32], n, share(n)))
+    if args.hot:
+        print("\n%-18s %-40s %9s %7s" % ("address", "symbol+offset", "samples", "share"))
+        for addr, n in sorted(hist, key=lambda an: an[1], reverse=True)[:args.hot]:
+            name, off = resolve(syms, addrs_of, addr)
+            print("0x%-16x %-40s %9d %6.1f%%" % (addr, ("%s+0x%x" % (name, off))[:40], n, share(n)))
+
+
+if __name__ == "__main__":
+    main()
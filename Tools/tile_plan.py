@@ -0,0 +1,250 @@
+#!/usr/bin/env python3
+"""Tile sizes of the cache-blocked residual convolutions (DEFINE_CONV2D_TILED).
+
+Every legal (TOC, TOH, TIC) tile of a CHW conv layer is scored by replaying the
+loop nest of DEFINE_CONV2D_TILED through a set-associative true-LRU L1 data
+cache, the model of the symprof plugin (Tools/qemu-plugins/symprof.c): the
+score is the traffic from the next level, line fills per array (input,
+weights, partial sums on the stack, output). The untiled oc -> oh -> ow schedule
+of DEFINE_CONV2D is replayed for comparison. The activation buffers are placed
+way-aligned, as ResNet-8's 32 KiB statics are; the channel planes are then
+power-of-two strides apart and conflict in the same sets, which is what makes a
+wide TIC thrash a 4-way cache long before the tile exceeds its size. Weights
+and the stack are placed half and a quarter way off.
+
+To keep the replay fast, the window of output pixels that touch the same lines
+is simulated twice (cold, then steady state) and extrapolated to the rest, and
+only the first three and the last strip / output-channel group are replayed
+(about half a minute per geometry). Among the tiles within 5% of the least
+traffic, the one with the fewest input-channel passes (partial-sum updates) is
+printed as build flags for resnet8.c -DCONV_TILED; ResNet-8/tiling.h holds the
+choice for common geometries.
+
+  python3 Tools/tile_plan.py --dcache 16384:4:32
+  python3 Tools/tile_plan.py --dcache 8192:2:32 --top 10 --layer 32,32,32,32,3,1,1
+
+Check the chosen schedule on the target with the symprof plugin
+(Tools/profile.py --dcache <same geometry>): the D-bytes column of the
+conv2d_qrelu_32in / conv2d_qlinear_32in rows is the total over the three
+residual blocks.
+"""
+import argparse
+import sys
+
+ACC_MAX = 4096  # KERNELS_TILE_ACC_MAX
+PICK_MARGIN = 0.05
+ARRAYS = ("in", "w", "acc", "out")
+
+
+def divisors(n):
+    return [d for d in range(1, n + 1) if n % d == 0]
+
+
+def out_dim(n, k, s, p):
+    return (n + 2 * p - k) // s + 1
+
+
+class Cache:
+    """True-LRU set-associative cache; counts line fills per array."""
+
+    def __init__(self, spec):
+        self.size, self.assoc, self.line = (int(x) for x in spec.split(":"))
+        self.sets = self.size // (self.assoc * self.line)
+        way = self.sets * self.line
+        self.base = {"in": 0, "out": 1 << 24, "w": (2 << 24) + way // 2, "acc": (3 << 24) + way // 4}
+        self.reset()
+
+    def reset(self):
+        self.lru = [[] for _ in range(self.sets)]
+        self.fills = dict.fromkeys(ARRAYS, 0)
+
+    def lines(self, array, offset, length):
+        a = self.base[array] + offset
+        return tuple((array, ln) for ln in range(a // self.line, (a + length - 1) // self.line + 1))
+
+    def run(self, seq, scale=1):
+        for array, ln in seq:
+            ways = self.lru[ln % self.sets]
+            if ln in ways:
+                ways.remove(ln)
+            else:
+                self.fills[array] += scale
+                if len(ways) == self.assoc:
+                    del ways[0]
+            ways.append(ln)
+
+    def passes(self, runs):
+        """Runs [(window, tails, pixels)]: the window is simulated for the first two pixels
+        (cold, steady state) and its steady-state fills extrapolated to the rest."""
+        for seq, tails, n in runs:
+            self.run(seq + tails[0])
+            if n > 1:
+                before = dict(self.fills)
+                self.run(seq)
+                steady = {a: self.fills[a] - before[a] for a in ARRAYS}
+                for tail in tails[1:]:
+                    self.run(tail)
+                for a in ARRAYS:
+                    self.fills[a] += steady[a] * (n - 2)
+
+    def replay(self, n, body):
+        """body(i) for i in 0, 1, 2 and n - 1; the middle iterations count as many times iteration 2."""
+        steady = None
+        for i in range(n) if n <= 4 else (0, 1, 2, n - 1):
+            before = dict(self.fills)
+            body(i)
+            if i == 2:
+                steady = {a: self.fills[a] - before[a] for a in ARRAYS}
+        if n > 4:
+            for a in ARRAYS:
+                self.fills[a] += steady[a] * (n - 4)
+
+
+def last_touch(seq):
+    """Distinct lines in order of last access: the same LRU state for a short repeated run."""
+    seen, out = set(), []
+    for x in reversed(seq):
+        if x not in seen:
+            seen.add(x)
+            out.append(x)
+    return out[::-1]
+
+
+def window(cache, layer, oc, ic0, tic, ih0, iw0):
+    """Lines touched by one output pixel: in[ic][ih0 + kh][iw0 + kw] * w[oc][ic][kh][kw]."""
+    ic, ih, iw, _, k, _, _ = layer
+    kw0, kw1 = max(0, -iw0), min(k, iw - iw0)
+    line, base_in, base_w = cache.line, cache.base["in"], cache.base["w"]
+    seq = []
+    for c in range(ic0, ic0 + tic):
+        for kh in range(max(0, -ih0), min(k, ih - ih0)):
+            a = base_in + (c * ih + ih0 + kh) * iw + iw0 + kw0
+            b = base_w + ((oc * ic + c) * k + kh) * k + kw0
+            n = kw1 - kw0
+            if a // line == (a + n - 1) // line and b // line == (b + n - 1) // line:
+                seq += (("in", a // line), ("w", b // line))
+            else:
+                row = []
+                for kw in range(n):
+                    row += (("in", (a + kw) // line), ("w", (b + kw) // line))
+                seq += last_touch(row)
+    return tuple(seq)
+
+
+def row_runs(cache, layer, oc, ic0, tic, ih0, sink):
+    """One output row as [(window, tails, pixels)]: neighbouring pixels that touch the
+    same input and weight lines (input rows a multiple of the line size) share a window;
+    tails are the distinct lines the pixels write to the sink (array, offset, bytes
+    per pixel)."""
+    ic, ih, iw, _, k, s, p = layer
+    array, offset, size = sink
+    runs, key = [], None
+    for x in range(out_dim(iw, k, s, p)):
+        iw0 = x * s - p
+        lo, hi = max(0, iw0), min(iw, iw0 + k) - 1
+        wkey = (lo // cache.line, hi // cache.line, lo - iw0, hi - iw0) if iw % cache.line == 0 else x
+        tail = cache.lines(array, offset + x * size, size)
+        if wkey == key:
+            runs[-1][2] += 1
+            if tail != runs[-1][1][-1]:
+                runs[-1][1].append(tail)
+        else:
+            key = wkey
+            runs.append([window(cache, layer, oc, ic0, tic, ih0, iw0), [tail], 1])
+    return runs
+
+
+def untiled(layer, cache):
+    ic, ih, iw, oc, k, s, p = layer
+    oh, ow = out_dim(ih, k, s, p), out_dim(iw, k, s, p)
+
+    def channel(o):
+        for y in range(oh):
+            cache.passes(row_runs(cache, layer, o, 0, ic, y * s - p, ("out", (o * oh + y) * ow, 1)))
+
+    cache.reset()
+    cache.replay(oc, channel)
+    return {a: n * cache.line for a, n in cache.fills.items()}
+
+
+def tiled(layer, cache, toc, toh, tic):
+    ic, ih, iw, oc, k, s, p = layer
+    oh, ow = out_dim(ih, k, s, p), out_dim(iw, k, s, p)
+
+    def acc_rows(j, r):
+        return cache.lines("acc", 4 * (j * toh + r) * ow, 4 * ow)
+
+    def group(oh0, oc0):
+        for j in range(toc):
+            for r in range(toh):
+                cache.run(acc_rows(j, r))
+        for ic0 in range(0, ic, tic):
+            for j in range(toc):
+                for r in range(toh):
+                    cache.passes(row_runs(cache, layer, oc0 + j, ic0, tic, (oh0 + r) * s - p,
+                                          ("acc", 4 * (j * toh + r) * ow, 4)))
+        for j in range(toc):
+            for r in range(toh):
+                cache.run(acc_rows(j, r) + cache.lines("out", ((oc0 + j) * oh + oh0 + r) * ow, ow))
+
+    cache.reset()
+    cache.replay(oh // toh, lambda st: cache.replay(oc // toc, lambda g: group(st * toh, g * toc)))
+    return {a: n * cache.line for a, n in cache.fills.items()}
+
+
+def total(t):
+    return sum(t.values())
+
+
+def plan(layer, cache):
+    """Candidates by traffic; the pick is the tile with the fewest input-channel passes
+    (partial-sum updates) among those within PICK_MARGIN of the least traffic."""
+    ic, ih, iw, oc, k, s, p = layer
+    oh, ow = out_dim(ih, k, s, p), out_dim(iw, k, s, p)
+    cands = []
+    for toc in divisors(oc):
+        for toh in divisors(oh):
+            if 4 * toc * toh * ow > ACC_MAX:
+                continue
+            for tic in divisors(ic):
+                t = tiled(layer, cache, toc, toh, tic)
+                cands.append((total(t), (toc, toh, tic), t))
+    cands.sort()
+    if not cands:
+        return cands, None, untiled(layer, cache)
+    near = [c for c in cands if c[0] <= cands[0][0] * (1 + PICK_MARGIN)]
+    pick = min(near, key=lambda c: (ic // c[1][2], c[0]))[1]
+    return cands, pick, untiled(layer, cache)
+
+
+def kib(n):
+    return "%.1f" % (n / 1024.0)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--dcache", default="32768:8:64", help="L1 D-cache size:assoc:line (bytes)")
+    ap.add_argument("--layer", default="32,32,32,32,3,1,1", help="in_c,in_h,in_w,out_c,k,stride,pad")
+    ap.add_argument("--top", type=int, default=5, help="candidate tiles to list")
+    args = ap.parse_args()
+    layer = tuple(int(x) for x in args.layer.split(","))
+    if len(layer) != 7:
+        sys.exit("tile_plan: --layer needs 7 values")
+
+    cache = Cache(args.dcache)
+    cands, pick, base = plan(layer, cache)
+    if not cands:
+        sys.exit("tile_plan: no tile fits KERNELS_TILE_ACC_MAX")
+    print("layer %s, L1D %s (size:assoc:line), line fills per layer in KiB" % (args.layer, args.dcache))
+    print("%-16s %9s %9s %9s %9s %9s" % ("schedule", "in", "weights", "acc", "out", "total"))
+    print("%-16s %9s %9s %9s %9s %9s" % ("untiled", kib(base["in"]), kib(base["w"]), kib(base["acc"]),
+                                         kib(base["out"]), kib(total(base))))
+    for _, (toc, toh, tic), t in cands[:args.top]:
+        print("%-16s %9s %9s %9s %9s %9s" % ("oc%d oh%d ic%d" % (toc, toh, tic), kib(t["in"]), kib(t["w"]),
+                                             kib(t["acc"]), kib(t["out"]), kib(total(t))))
+    toc, toh, tic = pick
+    print("\n-DCONV_TILED -DCONV_TILE_OC=%d -DCONV_TILE_OH=%d -DCONV_TILE_IC=%d" % (toc, toh, tic))
+
+
+if __name__ == "__main__":
+    main()
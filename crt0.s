@@ -1,6 +1,32 @@
     .section .text
     .globl _start
+    .type _start, @function
 _start:
+    csrr t0, mhartid
+    bnez t0, 3f              # harts 1..: wait for hart_entry (pipeline.h)
     la   sp, _stack_top      # stack
+    la   t0, _stack_start    # paint the stack for the high-water mark (footprint.h)
+    li   t1, 0x5a5a5a5a
+1:  sw   t1, 0(t0)
+    addi t0, t0, 4
+    bltu t0, sp, 1b
     call main                # calls main C
-1:  j 1b                     # infinite loop
+2:  j 2b                     # infinite loop
+3:  li   t1, 4               # harts 1..3 own a slice of .stack.harts, the others park
+    bgeu t0, t1, 2b
+    la   sp, _hart_stacks_start
+    slli t1, t0, 14          # top of hart N's stack = _hart_stacks_start + N * 16 KiB
+    add  sp, sp, t1
+4:  la   t1, hart_entry      # spin until hart 0 publishes an entry point
+    ld   t2, 0(t1)
+    beqz t2, 4b
+    mv   a0, t0              # entry(hartid)
+    jalr t2
+    j    2b
+    .size _start, .-_start
+
+    .section .data
+    .balign 8
+    .globl hart_entry
+hart_entry:
+    .dword 0
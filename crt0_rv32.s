@@ -0,0 +1,36 @@
+    # Startup for the rv32imc microcontroller layout (link_rv32.ld): code and
+    # initialised data in flash, .data copied to RAM, .bss zeroed, one hart.
+    .section .text.start, "ax"
+    .globl _start
+    .type _start, @function
+_start:
+    csrr t0, mhartid
+    bnez t0, 6f              # single-hart target: the other harts park
+    .option push
+    .option norelax
+    la   gp, __global_pointer$
+    .option pop
+    la   sp, _stack_top      # stack
+    la   t0, _data_load      # .data: flash image -> RAM
+    la   t1, _data_start
+    la   t2, _data_end
+    bgeu t1, t2, 2f
+1:  lw   t3, 0(t0)
+    sw   t3, 0(t1)
+    addi t0, t0, 4
+    addi t1, t1, 4
+    bltu t1, t2, 1b
+2:  la   t1, _bss_start      # .bss: zero
+    la   t2, _bss_end
+    bgeu t1, t2, 4f
+3:  sw   zero, 0(t1)
+    addi t1, t1, 4
+    bltu t1, t2, 3b
+4:  la   t0, _stack_start    # paint the stack for the high-water mark (footprint.h)
+    li   t1, 0x5a5a5a5a
+5:  sw   t1, 0(t0)
+    addi t0, t0, 4
+    bltu t0, sp, 5b
+    call main                # calls main C
+6:  j 6b                     # infinite loop
+    .size _start, .-_start